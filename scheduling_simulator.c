@@ -1,16 +1,108 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // Emulation mode: CPU affinity aur per-thread nice ke liye
+#endif
 #include "simulator.h"
 #include <string.h> // memcpy ke liye
+#include <stddef.h> // max_align_t ke liye
+#include <stdatomic.h> // Memory counters parallel runs mein bhi sahi rahein
+#include <signal.h> // SIGUSR1 snapshot ke liye
+#include <time.h>
+#include <math.h>   // sqrt (sampling confidence intervals) ke liye
+#include <errno.h>  // strtol range check (command line parsing)
+#if defined(__AVX2__)
+#include <immintrin.h> // CSV fast path ke liye
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(_WIN32)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h> // Peak RSS (getrusage) ke liye
+#include <sys/socket.h>   // Daemon mode ke liye
+#include <sys/time.h>     // Daemon client read timeout
+#include <sys/un.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>        // Shared-memory export aur workload mmap ke liye
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sched.h>        // Emulation threads ki CPU affinity
+#include <sys/syscall.h>  // gettid (per-thread nice)
+#endif
+#endif
 
 // --- Global Variables ---
 Process processes[MAX_PROCESSES];
 int process_count = 0;
 int next_pid = 1;
 
+#ifndef SIM_FUZZ
 // Program ka main entry point.
-int main() {
+// Bina arguments ke interactive menu chalta hai; "--validate", "--run" aur "--daemon" batch modes ke liye hain.
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--validate") == 0) {
+        long runs = (argc > 2) ? atol(argv[2]) : 1000000;
+        uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 12345;
+        // Sampling check har workload par poora engine chalata hai, isliye kam runs.
+        return (validate_engines(runs, seed) && validate_sampling(runs / 100 + 1, seed)) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--run") == 0) {
+        return run_batch(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--daemon") == 0) {
+        return run_daemon(argc, argv);
+    }
+    if (argc > 2 && strcmp(argv[1], "--dump-columnar") == 0) {
+        return dump_columnar(argv[2]);
+    }
+    if (argc > 1 && strcmp(argv[1], "--diff") == 0) {
+        return run_diff(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--diff-policies") == 0) {
+        return run_policy_diff(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--sample") == 0) {
+        return run_sample(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--race") == 0) {
+        return run_race(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--fused") == 0) {
+        return run_fused(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--transform") == 0) {
+        return run_transform(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        return run_sweep(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--min-cpus") == 0) {
+        return run_min_cpus(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--closed") == 0) {
+        return run_closed(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--partition") == 0) {
+        return run_partition(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-queues") == 0) {
+        return run_bench_queues(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--emulate") == 0) {
+        return run_emulate(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--fluid") == 0) {
+        return run_fluid(argc, argv);
+    }
+
     handle_user_choice();
     return 0;
 }
+#endif
 
 // User ko saare options dikhane ke liye menu.
 void display_menu() {
@@ -23,7 +115,10 @@ void display_menu() {
     printf("| 4. Run Priority Scheduling - Preemptive          |\n");
     printf("| 5. Run Round Robin (RR)                            |\n");
     printf("| 6. Compare All Algorithms & Find Best              |\n");
-    printf("| 7. Exit                                            |\n");
+    printf("| 7. Validate Fast Engine Against Reference          |\n");
+    printf("| 8. Load Processes From File (CSV/Binary)           |\n");
+    printf("| 9. Race Algorithms (Prune Losers Early)            |\n");
+    printf("| 10. Exit                                           |\n");
     printf("+----------------------------------------------------+\n");
     printf("Enter your choice: ");
 }
@@ -36,9 +131,10 @@ void handle_user_choice() {
         int result = scanf("%d", &choice);
         
         // Input sahi hai ya nahi, yeh check karne ke liye.
+        if (result == EOF) return; // Input khatam (piped input), menu band
         if (result != 1) {
             printf("\n[ERROR] Invalid input. Please enter a number.\n");
-            while (getchar() != '\n'); // Input buffer ko clear karo
+            discard_input_line(); // Input buffer ko clear karo
             choice = 0;
             continue;
         }
@@ -50,10 +146,13 @@ void handle_user_choice() {
             case 4: run_priority_preemptive(); break;
             case 5: run_round_robin(); break;
             case 6: compare_all_algorithms(); break;
-            case 7: printf("\nExiting simulator. Goodbye!\n"); break;
+            case 7: validate_engines(100000, 12345); break;
+            case 8: load_processes_from_file(); break;
+            case 9: race_all_algorithms(); break;
+            case 10: printf("\nExiting simulator. Goodbye!\n"); break;
             default: printf("\n[ERROR] Invalid choice. Please try again.\n"); break;
         }
-    } while (choice != 7);
+    } while (choice != 10);
 }
 
 // User se process ki details lekar list mein add karta hai.
@@ -70,19 +169,22 @@ void add_process() {
     printf("Enter Arrival Time: ");
     if(scanf("%d", &p.arrival_time) != 1 || p.arrival_time < 0) {
         printf("[ERROR] Invalid arrival time. Must be a non-negative integer.\n");
-        while(getchar()!='\n'); return;
+        discard_input_line();
+        return;
     }
 
     printf("Enter Burst Time: ");
     if(scanf("%d", &p.burst_time) != 1 || p.burst_time <= 0) {
         printf("[ERROR] Invalid burst time. Must be a positive integer.\n");
-        while(getchar()!='\n'); return;
+        discard_input_line();
+        return;
     }
 
     printf("Enter Priority (lower number = higher priority): ");
      if(scanf("%d", &p.priority) != 1 || p.priority < 0) {
         printf("[ERROR] Invalid priority. Must be a non-negative integer.\n");
-        while(getchar()!='\n'); return;
+        discard_input_line();
+        return;
     }
 
     p.remaining_time = p.burst_time;
@@ -97,7 +199,7 @@ void add_process() {
 
 // Process ke liye memory block allocate karne ka simulation.
 void simulate_memory_allocation(Process* p) {
-    p->memory_block = malloc(p->burst_time * sizeof(char) * 10);
+    p->memory_block = sim_malloc(p->burst_time * sizeof(char) * 10, MEM_MEMORY_SIM);
     if (p->memory_block == NULL) {
         printf("[MEMORY_SIM] Failed to allocate memory for PID %d.\n", p->pid);
     } else {
@@ -109,12 +211,142 @@ void simulate_memory_allocation(Process* p) {
 void simulate_memory_free(Process* p) {
     if (p->memory_block != NULL) {
         printf("[MEMORY_SIM] Freeing memory for PID %d from address %p.\n", p->pid, p->memory_block);
-        free(p->memory_block);
+        sim_free(p->memory_block);
         p->memory_block = NULL;
     }
 }
 
 
+// --- Memory Accounting ---
+// Har allocation ke aage ek chhota header hota hai jisme size aur subsystem rakhe jaate hain,
+// taaki free karte waqt sahi subsystem ka counter ghataya ja sake.
+
+typedef union {
+    struct {
+        size_t size;
+        int subsystem;
+    } info;
+    max_align_t align;    // Header ke baad wala pointer har type ke liye aligned rahe
+} AllocHeader;
+
+typedef struct {
+    _Atomic long long current_bytes;
+    _Atomic long long peak_bytes;
+    _Atomic long long total_bytes;
+    _Atomic long long allocations;
+} MemCounters;
+
+static MemCounters mem_counters[MEM_SUBSYSTEM_COUNT];
+
+static const char* mem_subsystem_names[MEM_SUBSYSTEM_COUNT] = {
+    "Process table", "Queues", "Gantt chart", "Memory sim", "Metrics", "File I/O"
+};
+
+static void mem_account(int subsystem, long long delta, bool new_allocation) {
+    MemCounters* c = &mem_counters[subsystem];
+    long long now = atomic_fetch_add(&c->current_bytes, delta) + delta;
+    if (delta > 0) atomic_fetch_add(&c->total_bytes, delta);
+    if (new_allocation) atomic_fetch_add(&c->allocations, 1);
+
+    long long peak = atomic_load(&c->peak_bytes);
+    while (now > peak && !atomic_compare_exchange_weak(&c->peak_bytes, &peak, now));
+}
+
+void* sim_malloc(size_t size, MemSubsystem subsystem) {
+    AllocHeader* h = malloc(sizeof(AllocHeader) + size);
+    if (h == NULL) return NULL;
+    h->info.size = size;
+    h->info.subsystem = subsystem;
+    mem_account(subsystem, (long long)size, true);
+    return h + 1;
+}
+
+void* sim_realloc(void* ptr, size_t size, MemSubsystem subsystem) {
+    if (ptr == NULL) return sim_malloc(size, subsystem);
+
+    AllocHeader* old = (AllocHeader*)ptr - 1;
+    size_t old_size = old->info.size;
+    int old_subsystem = old->info.subsystem;
+    AllocHeader* h = realloc(old, sizeof(AllocHeader) + size);
+    if (h == NULL) return NULL;
+
+    h->info.size = size;
+    h->info.subsystem = subsystem;
+    if (old_subsystem != (int)subsystem) {
+        mem_account(old_subsystem, -(long long)old_size, false);
+        mem_account(subsystem, (long long)size, true);
+    } else {
+        mem_account(subsystem, (long long)size - (long long)old_size, true);
+    }
+    return h + 1;
+}
+
+void sim_free(void* ptr) {
+    if (ptr == NULL) return;
+    AllocHeader* h = (AllocHeader*)ptr - 1;
+    mem_account(h->info.subsystem, -(long long)h->info.size, false);
+    free(h);
+}
+
+// Naye run ke liye peak ko current level par le aata hai (total aur count chalte rehte hain).
+void memory_stats_reset_peaks() {
+    for (int i = 0; i < MEM_SUBSYSTEM_COUNT; i++) {
+        atomic_store(&mem_counters[i].peak_bytes, atomic_load(&mem_counters[i].current_bytes));
+    }
+}
+
+// Process ka peak resident set size (KB mein), agar OS batata hai; warna -1.
+long peak_rss_kb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return (long)(pmc.PeakWorkingSetSize / 1024);
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024; // macOS bytes mein deta hai
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Subsystem-wise memory usage ka table print karta hai.
+void print_memory_report() {
+    long long total_current = 0, total_peak = 0, total_allocs = 0;
+
+    printf("\n--- SIMULATOR MEMORY USAGE ---\n");
+    printf("+---------------+----------------+----------------+----------------+-------------+\n");
+    printf("| Subsystem     | Current Bytes  | Peak Bytes     | Total Bytes    | Allocations |\n");
+    printf("+---------------+----------------+----------------+----------------+-------------+\n");
+    for (int i = 0; i < MEM_SUBSYSTEM_COUNT; i++) {
+        MemCounters* c = &mem_counters[i];
+        long long current = atomic_load(&c->current_bytes);
+        long long peak = atomic_load(&c->peak_bytes);
+        long long allocs = atomic_load(&c->allocations);
+        printf("| %-13s | %-14lld | %-14lld | %-14lld | %-11lld |\n",
+               mem_subsystem_names[i], current, peak, atomic_load(&c->total_bytes), allocs);
+        total_current += current;
+        total_peak += peak;
+        total_allocs += allocs;
+    }
+    printf("+---------------+----------------+----------------+----------------+-------------+\n");
+    printf("| Tracked current: %lld bytes, sum of peaks: %lld bytes, allocations: %lld\n",
+           total_current, total_peak, total_allocs);
+    long rss = peak_rss_kb();
+    if (rss >= 0) printf("| Peak RSS       : %ld KB\n", rss);
+    printf("+---------------------------------------------------------------------------------+\n");
+}
+
+
+// Galat input ke baad line ka baaki hissa chhod deta hai; EOF par bhi ruk jaata hai.
+void discard_input_line() {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF) {
+    }
+}
+
 // Naye simulation ke liye sabhi process ki state ko reset karta hai.
 void reset_process_state() {
     for (int i = 0; i < process_count; i++) {
@@ -122,6 +354,7 @@ void reset_process_state() {
         processes[i].is_completed = false;
         processes[i].completion_time = 0;
         processes[i].turnaround_time = 0;
+        processes[i].response_time = 0;
         processes[i].waiting_time = 0;
     }
 }
@@ -132,7 +365,32 @@ void copy_processes(Process dest[], Process src[], int n) {
         dest[i] = src[i];
         dest[i].remaining_time = src[i].burst_time;
         dest[i].is_completed = false;
+        dest[i].completion_time = 0;
+    }
+}
+
+// Fast engine chalakar results aur Gantt chart print karta hai (menu options ke liye).
+static void run_with_engine(Policy policy, int time_quantum, const char* algorithm_name) {
+    Process procs[MAX_PROCESSES];
+    copy_processes(procs, processes, process_count);
+
+    SimEngine engine;
+    if (!engine_init(&engine, policy, time_quantum, procs, process_count, true)) {
+        printf("\n[ERROR] Failed to allocate memory for the simulation.\n");
+        return;
     }
+    engine_run(&engine);
+
+    // Memory sirf global table se free hoti hai, taaki dobara run karne par double free na ho.
+    for (int i = 0; i < process_count; i++) {
+        simulate_memory_free(&processes[i]);
+    }
+
+    calculate_metrics(procs, process_count);
+    print_results_table(procs, process_count, algorithm_name);
+    print_schedstat(&engine, true);
+    print_gantt_chart(engine.gantt, engine.gantt_count);
+    engine_free(&engine);
 }
 
 // First-Come, First-Served (FCFS) algorithm ka simulation.
@@ -141,15 +399,56 @@ void run_fcfs() {
         printf("\n[ERROR] No processes to schedule. Please add processes first.\n");
         return;
     }
-    
-    Process procs[MAX_PROCESSES];
-    copy_processes(procs, processes, process_count);
-    GanttEntry gantt_chart[MAX_PROCESSES * 2];
+    run_with_engine(POLICY_FCFS, 0, "First-Come, First-Served (FCFS)");
+}
+
+// Preemptive Shortest Job First (SJF) algorithm ka simulation.
+void run_sjf_preemptive() {
+    if (process_count == 0) {
+        printf("\n[ERROR] No processes to schedule.\n");
+        return;
+    }
+    run_with_engine(POLICY_SJF, 0, "Preemptive Shortest Job First (SJF)");
+}
+
+// Preemptive Priority scheduling algorithm ka simulation.
+void run_priority_preemptive() {
+    if (process_count == 0) {
+        printf("\n[ERROR] No processes to schedule.\n");
+        return;
+    }
+    run_with_engine(POLICY_PRIORITY, 0, "Preemptive Priority Scheduling");
+}
+
+// Round Robin (RR) scheduling algorithm ka simulation.
+void run_round_robin() {
+    if (process_count == 0) {
+        printf("\n[ERROR] No processes to schedule.\n");
+        return;
+    }
+
+    int time_quantum;
+    printf("\nEnter Time Quantum for Round Robin: ");
+    if (scanf("%d", &time_quantum) != 1 || time_quantum <= 0) {
+        printf("[ERROR] Invalid time quantum. Must be a positive integer.\n");
+        discard_input_line();
+        return;
+    }
+    run_with_engine(POLICY_RR, time_quantum, "Round Robin (RR)");
+}
+
+
+// --- Reference Algorithms ---
+// Yeh original tick-by-tick implementations hain. Inhe jaan-boojhkar simple rakha gaya hai,
+// taaki validation harness inhe "oracle" ki tarah fast engine ke against use kar sake.
+
+// FCFS reference: arrival time se (stable) sort karke ek-ek process chalana.
+int reference_fcfs(Process procs[], int n, GanttEntry chart[]) {
     int gantt_count = 0;
-    
+
     // Processes ko arrival time ke hisab se sort karna.
-    for (int i = 0; i < process_count - 1; i++) {
-        for (int j = 0; j < process_count - i - 1; j++) {
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n - i - 1; j++) {
             if (procs[j].arrival_time > procs[j + 1].arrival_time) {
                 Process temp = procs[j];
                 procs[j] = procs[j + 1];
@@ -157,53 +456,38 @@ void run_fcfs() {
             }
         }
     }
-    
+
     int current_time = 0;
-    for (int i = 0; i < process_count; i++) {
+    for (int i = 0; i < n; i++) {
         if (current_time < procs[i].arrival_time) {
             current_time = procs[i].arrival_time; // CPU khali hai.
         }
-        
-        gantt_chart[gantt_count].pid = procs[i].pid;
-        gantt_chart[gantt_count].start_time = current_time;
-        
+
+        chart[gantt_count].pid = procs[i].pid;
+        chart[gantt_count].start_time = current_time;
+
         current_time += procs[i].burst_time;
         procs[i].completion_time = current_time;
-        
-        gantt_chart[gantt_count].end_time = current_time;
-        gantt_count++;
 
-        simulate_memory_free(&procs[i]);
+        chart[gantt_count].end_time = current_time;
+        gantt_count++;
     }
-
-    calculate_metrics(procs, process_count);
-    print_results_table(procs, process_count, "First-Come, First-Served (FCFS)");
-    print_gantt_chart(gantt_chart, gantt_count);
+    return gantt_count;
 }
 
-
-// Preemptive Shortest Job First (SJF) algorithm ka simulation.
-void run_sjf_preemptive() {
-    if (process_count == 0) {
-        printf("\n[ERROR] No processes to schedule.\n");
-        return;
-    }
-
-    Process procs[MAX_PROCESSES];
-    copy_processes(procs, processes, process_count);
-    GanttEntry gantt_chart[MAX_PROCESSES * 10];
+// Preemptive SJF reference: har time unit par sabse kam remaining time wala process.
+int reference_sjf_preemptive(Process procs[], int n, GanttEntry chart[]) {
     int gantt_count = 0;
-    
     int current_time = 0;
     int completed_count = 0;
     int last_pid = -1;
 
-    while (completed_count < process_count) {
+    while (completed_count < n) {
         int shortest_job_idx = -1;
         int min_remaining_time = INT_MAX;
 
         // Sabse kam remaining time wala process dhundhna jo aa chuka hai.
-        for (int i = 0; i < process_count; i++) {
+        for (int i = 0; i < n; i++) {
             if (procs[i].arrival_time <= current_time && !procs[i].is_completed) {
                 if (procs[i].remaining_time < min_remaining_time) {
                     min_remaining_time = procs[i].remaining_time;
@@ -216,16 +500,16 @@ void run_sjf_preemptive() {
             current_time++; // CPU khali hai.
             continue;
         }
-        
+
         int current_pid = procs[shortest_job_idx].pid;
 
         // Gantt chart ke liye: agar process badalta hai toh nayi entry.
         if(last_pid != current_pid) {
              if(gantt_count > 0) {
-                gantt_chart[gantt_count-1].end_time = current_time;
+                chart[gantt_count-1].end_time = current_time;
             }
-            gantt_chart[gantt_count].pid = current_pid;
-            gantt_chart[gantt_count].start_time = current_time;
+            chart[gantt_count].pid = current_pid;
+            chart[gantt_count].start_time = current_time;
             gantt_count++;
         }
         last_pid = current_pid;
@@ -237,39 +521,26 @@ void run_sjf_preemptive() {
             procs[shortest_job_idx].completion_time = current_time;
             procs[shortest_job_idx].is_completed = true;
             completed_count++;
-            simulate_memory_free(&procs[shortest_job_idx]);
             last_pid = -1;
         }
     }
-    gantt_chart[gantt_count-1].end_time = current_time;
-
-    calculate_metrics(procs, process_count);
-    print_results_table(procs, process_count, "Preemptive Shortest Job First (SJF)");
-    print_gantt_chart(gantt_chart, gantt_count);
+    chart[gantt_count-1].end_time = current_time;
+    return gantt_count;
 }
 
-// Preemptive Priority scheduling algorithm ka simulation.
-void run_priority_preemptive() {
-    if (process_count == 0) {
-        printf("\n[ERROR] No processes to schedule.\n");
-        return;
-    }
-
-    Process procs[MAX_PROCESSES];
-    copy_processes(procs, processes, process_count);
-    GanttEntry gantt_chart[MAX_PROCESSES * 10];
+// Preemptive Priority reference: har time unit par sabse chhote priority number wala process.
+int reference_priority_preemptive(Process procs[], int n, GanttEntry chart[]) {
     int gantt_count = 0;
-    
     int current_time = 0;
     int completed_count = 0;
     int last_pid = -1;
 
-    while (completed_count < process_count) {
+    while (completed_count < n) {
         int highest_priority_idx = -1;
         int min_priority = INT_MAX;
 
         // Sabse zyada priority wala process dhundhna (jiska priority number sabse kam ho).
-        for (int i = 0; i < process_count; i++) {
+        for (int i = 0; i < n; i++) {
             if (procs[i].arrival_time <= current_time && !procs[i].is_completed) {
                 if (procs[i].priority < min_priority) {
                     min_priority = procs[i].priority;
@@ -282,13 +553,13 @@ void run_priority_preemptive() {
             current_time++; // CPU khali hai.
             continue;
         }
-        
+
         int current_pid = procs[highest_priority_idx].pid;
 
         if(last_pid != current_pid) {
-            if(gantt_count > 0) gantt_chart[gantt_count-1].end_time = current_time;
-            gantt_chart[gantt_count].pid = current_pid;
-            gantt_chart[gantt_count].start_time = current_time;
+            if(gantt_count > 0) chart[gantt_count-1].end_time = current_time;
+            chart[gantt_count].pid = current_pid;
+            chart[gantt_count].start_time = current_time;
             gantt_count++;
         }
         last_pid = current_pid;
@@ -300,55 +571,36 @@ void run_priority_preemptive() {
             procs[highest_priority_idx].completion_time = current_time;
             procs[highest_priority_idx].is_completed = true;
             completed_count++;
-            simulate_memory_free(&procs[highest_priority_idx]);
             last_pid = -1;
         }
     }
-    gantt_chart[gantt_count-1].end_time = current_time;
-
-    calculate_metrics(procs, process_count);
-    print_results_table(procs, process_count, "Preemptive Priority Scheduling");
-    print_gantt_chart(gantt_chart, gantt_count);
+    chart[gantt_count-1].end_time = current_time;
+    return gantt_count;
 }
 
-// Round Robin (RR) scheduling algorithm ka simulation.
-void run_round_robin() {
-    if (process_count == 0) {
-        printf("\n[ERROR] No processes to schedule.\n");
-        return;
-    }
-
-    int time_quantum;
-    printf("\nEnter Time Quantum for Round Robin: ");
-    if (scanf("%d", &time_quantum) != 1 || time_quantum <= 0) {
-        printf("[ERROR] Invalid time quantum. Must be a positive integer.\n");
-        while(getchar()!='\n'); return;
-    }
-
-    Process procs[MAX_PROCESSES];
-    copy_processes(procs, processes, process_count);
-    GanttEntry gantt_chart[MAX_PROCESSES * 10];
+// Round Robin reference: har iteration mein queue ke aage wale process ko ek slice dena.
+int reference_round_robin(Process procs[], int n, int time_quantum, GanttEntry chart[]) {
     int gantt_count = 0;
 
     int ready_queue[MAX_PROCESSES];
     int front = -1, rear = -1;
     bool in_queue[MAX_PROCESSES + 1] = {false};
-    
+
     int current_time = 0;
     int completed_count = 0;
-    
+
     // Processes ko arrival time ke hisab se sort karna.
-    for (int i = 0; i < process_count - 1; i++) {
-        for (int j = 0; j < process_count - i - 1; j++) {
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n - i - 1; j++) {
             if (procs[j].arrival_time > procs[j+1].arrival_time) {
                 Process temp = procs[j]; procs[j] = procs[j+1]; procs[j+1] = temp;
             }
         }
     }
 
-    while (completed_count < process_count) {
+    while (completed_count < n) {
         // Naye aaye hue processes ko ready queue mein daalna.
-        for (int i = 0; i < process_count; i++) {
+        for (int i = 0; i < n; i++) {
             if (!procs[i].is_completed && procs[i].arrival_time <= current_time && !in_queue[procs[i].pid]) {
                 if (front == -1) front = 0;
                 rear = (rear + 1) % MAX_PROCESSES;
@@ -363,22 +615,26 @@ void run_round_robin() {
         }
 
         int current_proc_idx = ready_queue[front];
-        front = (front == rear) ? -1 : (front + 1) % MAX_PROCESSES;
+        // Queue khali hone par front aur rear dono reset, warna agla enqueue purane slots wapas le aata hai.
+        if (front == rear) { front = -1; rear = -1; }
+        else front = (front + 1) % MAX_PROCESSES;
         in_queue[procs[current_proc_idx].pid] = false;
-        
+
         int time_slice = (procs[current_proc_idx].remaining_time < time_quantum) ? procs[current_proc_idx].remaining_time : time_quantum;
-        
-        gantt_chart[gantt_count].pid = procs[current_proc_idx].pid;
-        gantt_chart[gantt_count].start_time = current_time;
-        
+
+        chart[gantt_count].pid = procs[current_proc_idx].pid;
+        chart[gantt_count].start_time = current_time;
+
         current_time += time_slice;
         procs[current_proc_idx].remaining_time -= time_slice;
-        
-        gantt_chart[gantt_count].end_time = current_time;
+
+        chart[gantt_count].end_time = current_time;
         gantt_count++;
 
         // Jo process is time slice ke dauran aaye, unhe queue mein add karna.
-        for (int i = 0; i < process_count; i++) {
+        // Abhi chala hua process yahan skip hota hai; woh neeche alag se queue ke peeche jaata hai.
+        for (int i = 0; i < n; i++) {
+            if (i == current_proc_idx) continue;
             if (!procs[i].is_completed && procs[i].arrival_time <= current_time && !in_queue[procs[i].pid]) {
                 if(front == -1) front = 0;
                 rear = (rear + 1) % MAX_PROCESSES;
@@ -391,7 +647,6 @@ void run_round_robin() {
             procs[current_proc_idx].is_completed = true;
             procs[current_proc_idx].completion_time = current_time;
             completed_count++;
-            simulate_memory_free(&procs[current_proc_idx]);
         } else {
             // Agar process poora nahi hua, toh use wapas queue mein daal do.
             if(front == -1) front = 0;
@@ -400,100 +655,7375 @@ void run_round_robin() {
             in_queue[procs[current_proc_idx].pid] = true;
         }
     }
-
-    calculate_metrics(procs, process_count);
-    print_results_table(procs, process_count, "Round Robin (RR)");
-    print_gantt_chart(gantt_chart, gantt_count);
+    return gantt_count;
 }
 
 
-// Sabhi processes ke liye waiting time aur turnaround time calculate karta hai.
-void calculate_metrics(Process procs[], int n) {
-    for (int i = 0; i < n; i++) {
-        for(int j=0; j < process_count; j++){
-            if(procs[i].pid == processes[j].pid){
-                 procs[i].turnaround_time = procs[i].completion_time - procs[i].arrival_time;
-                 procs[i].waiting_time = procs[i].turnaround_time - processes[j].burst_time;
-                 break;
-            }
-        }
-    }
+// --- Event Queues ---
+// Engine ke time-keyed events (dynamic arrivals, multi-CPU slice ends) ke liye pluggable queues.
+// Simulated time peeche nahi jaata: push ka time pichhle pop se kam nahi hota. Backends:
+//  - Binary heap (default) aur 4-ary heap: O(log n) push/pop.
+//  - Calendar queue (Brown 1988): time 'width' chaudai ke dinon (buckets) mein bata hai jo har saal
+//    (bucket_count dinon) ke baad wapas ghoomte hain. Har din ek sorted array hai; pop cursor wale din
+//    se aage dhoondhta hai. Entries bucket count ke do guna se zyada ya aadhe se kam hon toh buckets aur
+//    width dobara bante hain. Events ka time faila ho toh O(1) average; ek hi time par aaye storms
+//    sorted array ke aakhir mein judte hain.
+//  - Radix heap: key ko pichhli pop ki key se XOR karke highest alag bit wale bucket mein rakhta hai.
+//    Pop par pehla bhara bucket nayi key ke hisab se neeche bant jaata hai, isliye har entry zyada se
+//    zyada 32 baar hilti hai. Bucket 0 (time == pichhli key) ek chhota heap hai. Nodes ek pool mein hain,
+//    isliye pop kabhi allocate nahi karta.
+// Calendar aur radix 'first' mein sabse pehli entry alag se rakhte hain, taaki top O(1) rahe.
+
+#define EVENT_CALENDAR_MIN_BUCKETS 16
+#define EVENT_CALENDAR_SAMPLES 64  // Width ke andaze ke liye kitne times dekhne hain
+#define EVENT_BUCKET_INITIAL 4
+
+static EventQueueBackend event_queue_default = SIM_EVENT_QUEUE;
+
+static const char* const event_queue_names[EVENT_QUEUE_BACKEND_COUNT] = { "binary", "4ary", "calendar", "radix" };
+
+const char* event_queue_backend_name(EventQueueBackend backend) {
+    return (backend >= 0 && backend < EVENT_QUEUE_BACKEND_COUNT) ? event_queue_names[backend] : "unknown";
 }
 
-// Results ko ek saaf table format mein print karta hai.
-void print_results_table(Process procs[], int n, const char* algorithm_name) {
-    float total_wt = 0, total_tat = 0;
-    
-    // Output consistent rahe, isliye PID se sort karna.
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (procs[j].pid > procs[j + 1].pid) {
-                Process temp = procs[j]; procs[j] = procs[j + 1]; procs[j + 1] = temp;
-            }
+bool parse_event_queue_backend(const char* name, EventQueueBackend* out) {
+    for (int b = 0; b < EVENT_QUEUE_BACKEND_COUNT; b++) {
+        if (strcmp(name, event_queue_names[b]) == 0) {
+            *out = (EventQueueBackend)b;
+            return true;
         }
     }
+    return false;
+}
 
-    printf("\n\n--- RESULTS FOR: %s ---\n", algorithm_name);
-    printf("+-----+--------------+------------+----------+-----------------+-------------------+--------------+\n");
-    printf("| PID | Arrival Time | Burst Time | Priority | Completion Time | Turnaround Time | Waiting Time |\n");
-    printf("+-----+--------------+------------+----------+-----------------+-------------------+--------------+\n");
-    for (int i = 0; i < n; i++) {
-        printf("| %-3d | %-12d | %-10d | %-8d | %-15d | %-17d | %-12d |\n",
-               procs[i].pid, procs[i].arrival_time, processes[i].burst_time, procs[i].priority,
-               procs[i].completion_time, procs[i].turnaround_time, procs[i].waiting_time);
-        total_wt += procs[i].waiting_time;
-        total_tat += procs[i].turnaround_time;
-    }
-    printf("+-----+--------------+------------+----------+-----------------+-------------------+--------------+\n");
-    printf("| Average Waiting Time     : %.2f\n", total_wt / n);
-    printf("| Average Turnaround Time  : %.2f\n", total_tat / n);
-    printf("+------------------------------------------------------------------------------------------------+\n");
+// Engine ke naye queues kaunsa backend lein (--event-queue).
+void event_queue_set_default(EventQueueBackend backend) {
+    event_queue_default = backend;
 }
 
+// aux aakhri tie-break hai, taaki same (time, id) wali entries (jaise ek CPU ke purane aur naye slice)
+// bhi har backend mein ek hi order mein hon aur top wahi entry ho jo pop nikaalega.
+static bool queued_before(const QueuedEvent* a, const QueuedEvent* b) {
+    if (a->time != b->time) return a->time < b->time;
+    if (a->id != b->id) return a->id < b->id;
+    return a->aux < b->aux;
+}
 
-// Ek visual ASCII Gantt chart print karta hai.
-void print_gantt_chart(GanttEntry chart[], int n) {
-    printf("\n--- GANTT CHART ---\n\n");
+// --- Heaps ---
 
-    // Upar ka border
-    printf(" ");
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < (chart[i].end_time - chart[i].start_time) * 2; j++) printf("-");
-        printf(" ");
+static bool event_heap_push(EventQueue* q, QueuedEvent ev, int arity) {
+    if (q->count == q->capacity) {
+        int capacity = q->capacity * 2;
+        QueuedEvent* grown = sim_realloc(q->heap, (size_t)capacity * sizeof(QueuedEvent), MEM_QUEUES);
+        if (grown == NULL) return false;
+        q->heap = grown;
+        q->capacity = capacity;
     }
-    printf("\n|");
-
-    // Process IDs
-    for (int i = 0; i < n; i++) {
-        int duration = (chart[i].end_time - chart[i].start_time) * 2;
-        int padding = (duration - 4) / 2;
-        if(padding < 0) padding = 0;
-
-        for (int j = 0; j < padding; j++) printf(" ");
-        printf(" P%d ", chart[i].pid);
-        for (int j = 0; j < padding; j++) printf(" ");
-        if((duration - 4) % 2 != 0) printf(" ");
-        printf("|");
+    int i = q->count++;
+    while (i > 0) {
+        int parent = (i - 1) / arity;
+        if (!queued_before(&ev, &q->heap[parent])) break;
+        q->heap[i] = q->heap[parent];
+        i = parent;
     }
-    printf("\n ");
+    q->heap[i] = ev;
+    return true;
+}
 
-    // Neeche ka border
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < (chart[i].end_time - chart[i].start_time) * 2; j++) printf("-");
-        printf(" ");
+static void event_heap_pop(EventQueue* q, int arity) {
+    QueuedEvent last = q->heap[--q->count];
+    int i = 0;
+    while (true) {
+        int child = arity * i + 1;
+        if (child >= q->count) break;
+        int end = (child + arity < q->count) ? child + arity : q->count;
+        for (int c = child + 1; c < end; c++) {
+            if (queued_before(&q->heap[c], &q->heap[child])) child = c;
+        }
+        if (!queued_before(&q->heap[child], &last)) break;
+        q->heap[i] = q->heap[child];
+        i = child;
     }
-    printf("\n");
+    q->heap[i] = last;
+}
 
-    // Timestamps
-    printf("%d", chart[0].start_time);
-    for (int i = 0; i < n; i++) {
-        int duration = (chart[i].end_time - chart[i].start_time) * 2;
-        for (int j = 0; j < duration; j++) printf(" ");
+// --- Calendar Queue ---
 
-        if (chart[i].end_time > 9) printf("\b"); // do-digit numbers ke liye adjustment
-        printf("%d", chart[i].end_time);
-    }
-    printf("\n\n");
+// Time ko non-negative offset mein badalta hai, taaki negative times bhi sahi din mein jaayein.
+static long long event_offset(int time) {
+    return (long long)time - INT_MIN;
+}
+
+static int calendar_bucket(const EventQueue* q, int time) {
+    return (int)((event_offset(time) / q->width) & (q->bucket_count - 1));
+}
+
+static void calendar_set_first(EventQueue* q, int bucket) {
+    const EventBucket* b = &q->buckets[bucket];
+    q->first = b->items[b->head];
+    q->cursor = bucket;
+    q->cursor_top = (event_offset(q->first.time) / q->width + 1) * q->width;
+}
+
+static bool calendar_insert(EventQueue* q, QueuedEvent ev) {
+    EventBucket* b = &q->buckets[calendar_bucket(q, ev.time)];
+    if (b->head > 0 && b->count == b->capacity) {
+        memmove(b->items, &b->items[b->head], (size_t)(b->count - b->head) * sizeof(QueuedEvent));
+        b->count -= b->head;
+        b->head = 0;
+    }
+    if (b->count == b->capacity) {
+        int capacity = (b->capacity > 0) ? b->capacity * 2 : EVENT_BUCKET_INITIAL;
+        QueuedEvent* grown = sim_realloc(b->items, (size_t)capacity * sizeof(QueuedEvent), MEM_QUEUES);
+        if (grown == NULL) return false;
+        b->items = grown;
+        b->capacity = capacity;
+    }
+    // Zyaadatar naye events din ke aakhir mein aate hain, isliye peeche se jagah dhoondhna sasta hai.
+    int i = b->count;
+    while (i > b->head && queued_before(&ev, &b->items[i - 1])) {
+        b->items[i] = b->items[i - 1];
+        i--;
+    }
+    b->items[i] = ev;
+    b->count++;
+    return true;
+}
+
+static int compare_long_long(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Naya din ka width: Brown ke niyam se ek din mein lagbhag teen events. Entries ka ek barabar faila sample
+// lekar uske 10th aur 90th percentile ke beech ka time, us hisse ki entries se baanta jaata hai; isliye door
+// ke ikke-dukke events aur ek hi time par aaye storms andaze ko nahi bigadte.
+static long long calendar_width(const EventQueue* q) {
+    long long samples[EVENT_CALENDAR_SAMPLES];
+    int taken = 0;
+    int stride = (q->count > EVENT_CALENDAR_SAMPLES) ? q->count / EVENT_CALENDAR_SAMPLES : 1;
+    int seen = 0;
+    for (int i = 0; i < q->bucket_count && taken < EVENT_CALENDAR_SAMPLES; i++) {
+        const EventBucket* b = &q->buckets[i];
+        for (int k = b->head; k < b->count && taken < EVENT_CALENDAR_SAMPLES; k++) {
+            if (seen++ % stride == 0) samples[taken++] = b->items[k].time;
+        }
+    }
+    if (taken < 2) return q->width;
+    qsort(samples, taken, sizeof(long long), compare_long_long);
+    int trim = taken / 10;
+    int intervals = taken - 1 - 2 * trim;
+    long long span = samples[taken - 1 - trim] - samples[trim];
+    long long width = (long long)(3.0 * span * taken / ((double)intervals * q->count));
+    return (width > 0) ? width : 1;
+}
+
+// Buckets aur width dobara banata hai. Memory na mile toh purane buckets ke saath hi chalta rehta hai.
+static void calendar_resize(EventQueue* q, int bucket_count) {
+    EventBucket* buckets = sim_malloc((size_t)bucket_count * sizeof(EventBucket), MEM_QUEUES);
+    if (buckets == NULL) return;
+    memset(buckets, 0, (size_t)bucket_count * sizeof(EventBucket));
+    EventBucket* old = q->buckets;
+    int old_count = q->bucket_count;
+    long long old_width = q->width;
+    q->width = calendar_width(q);
+    q->buckets = buckets;
+    q->bucket_count = bucket_count;
+
+    bool ok = true;
+    for (int i = 0; ok && i < old_count; i++) {
+        for (int k = old[i].head; ok && k < old[i].count; k++) ok = calendar_insert(q, old[i].items[k]);
+    }
+    EventBucket* discard = ok ? old : buckets;
+    int discard_count = ok ? old_count : bucket_count;
+    for (int i = 0; i < discard_count; i++) sim_free(discard[i].items);
+    sim_free(discard);
+    if (!ok) {
+        q->buckets = old;
+        q->bucket_count = old_count;
+        q->width = old_width;
+    }
+    if (q->count > 0) calendar_set_first(q, calendar_bucket(q, q->first.time));
+}
+
+static bool calendar_push(EventQueue* q, QueuedEvent ev) {
+    if (q->count >= 2 * q->bucket_count) calendar_resize(q, q->bucket_count * 2);
+    if (!calendar_insert(q, ev)) return false;
+    if (q->count == 0 || queued_before(&ev, &q->first)) calendar_set_first(q, calendar_bucket(q, ev.time));
+    q->count++;
+    return true;
+}
+
+// Cursor wale din se aage har din ke bucket mein dekhta hai; poore saal mein kuch na mile (events door
+// hain) toh saare buckets ke heads mein se sabse pehla.
+static void calendar_find_first(EventQueue* q) {
+    int mask = q->bucket_count - 1;
+    long long top = q->cursor_top;
+    for (int k = 0; k < q->bucket_count; k++, top += q->width) {
+        int i = (q->cursor + k) & mask;
+        const EventBucket* b = &q->buckets[i];
+        if (b->head < b->count && event_offset(b->items[b->head].time) < top) {
+            q->first = b->items[b->head];
+            q->cursor = i;
+            q->cursor_top = top;
+            return;
+        }
+    }
+    int best = -1;
+    for (int i = 0; i < q->bucket_count; i++) {
+        const EventBucket* b = &q->buckets[i];
+        if (b->head < b->count && (best < 0 || queued_before(&b->items[b->head], &q->buckets[best].items[q->buckets[best].head]))) best = i;
+    }
+    calendar_set_first(q, best);
+}
+
+static void calendar_pop(EventQueue* q) {
+    EventBucket* b = &q->buckets[q->cursor];
+    if (++b->head == b->count) b->head = b->count = 0;
+    if (--q->count == 0) return;
+    calendar_find_first(q);
+    if (q->bucket_count > EVENT_CALENDAR_MIN_BUCKETS && q->count < q->bucket_count / 2) calendar_resize(q, q->bucket_count / 2);
+}
+
+// --- Radix Heap ---
+
+static unsigned radix_key(int time) {
+    return (unsigned)time ^ 0x80000000u;
+}
+
+// Node pool ko dugna karta hai; naye nodes free list mein.
+static bool radix_grow(EventQueue* q, int capacity) {
+    QueuedEvent* heap = sim_realloc(q->heap, (size_t)capacity * sizeof(QueuedEvent), MEM_QUEUES);
+    if (heap == NULL) return false;
+    q->heap = heap;
+    int* next = sim_realloc(q->next, (size_t)capacity * sizeof(int), MEM_QUEUES);
+    if (next == NULL) return false;
+    q->next = next;
+    int* zero = sim_realloc(q->zero, (size_t)capacity * sizeof(int), MEM_QUEUES);
+    if (zero == NULL) return false;
+    q->zero = zero;
+    for (int i = capacity - 1; i >= q->capacity; i--) {
+        q->next[i] = q->free_node;
+        q->free_node = i;
+    }
+    q->capacity = capacity;
+    return true;
+}
+
+// Node ko radix_last ke hisab se sahi bucket mein rakhta hai.
+static void radix_place(EventQueue* q, int node) {
+    unsigned diff = radix_key(q->heap[node].time) ^ q->radix_last;
+    if (diff != 0) {
+        int b = 32 - __builtin_clz(diff);
+        q->next[node] = q->radix_head[b];
+        q->radix_head[b] = node;
+        return;
+    }
+    int i = q->zero_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!queued_before(&q->heap[node], &q->heap[q->zero[parent]])) break;
+        q->zero[i] = q->zero[parent];
+        i = parent;
+    }
+    q->zero[i] = node;
+}
+
+static int radix_zero_pop(EventQueue* q) {
+    int top = q->zero[0];
+    int last = q->zero[--q->zero_count];
+    int i = 0;
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= q->zero_count) break;
+        if (child + 1 < q->zero_count && queued_before(&q->heap[q->zero[child + 1]], &q->heap[q->zero[child]])) child++;
+        if (!queued_before(&q->heap[q->zero[child]], &q->heap[last])) break;
+        q->zero[i] = q->zero[child];
+        i = child;
+    }
+    q->zero[i] = last;
+    return top;
+}
+
+// Monotone nahi hai aisa push (time pichhli pop se pehle): sabko nayi key ke hisab se dobara baantna.
+// Simulation mein nahi hota, par queue phir bhi sahi rehti hai.
+static void radix_rebase(EventQueue* q, unsigned key) {
+    int nodes = -1;
+    for (int b = 1; b < EVENT_RADIX_BUCKETS; b++) {
+        for (int node = q->radix_head[b], next; node >= 0; node = next) {
+            next = q->next[node];
+            q->next[node] = nodes;
+            nodes = node;
+        }
+        q->radix_head[b] = -1;
+    }
+    for (int i = 0; i < q->zero_count; i++) {
+        q->next[q->zero[i]] = nodes;
+        nodes = q->zero[i];
+    }
+    q->zero_count = 0;
+    q->radix_last = key;
+    for (int node = nodes, next; node >= 0; node = next) {
+        next = q->next[node];
+        radix_place(q, node);
+    }
+}
+
+static bool radix_push(EventQueue* q, QueuedEvent ev) {
+    if (q->free_node < 0 && !radix_grow(q, q->capacity * 2)) return false;
+    if (radix_key(ev.time) < q->radix_last) radix_rebase(q, radix_key(ev.time));
+    int node = q->free_node;
+    q->free_node = q->next[node];
+    q->heap[node] = ev;
+    radix_place(q, node);
+    if (q->count == 0 || queued_before(&ev, &q->first)) q->first = ev;
+    q->count++;
+    return true;
+}
+
+static void radix_pop(EventQueue* q) {
+    if (q->zero_count == 0) {
+        // 'first' sabse neeche wale bhare bucket mein hai; use nayi key banakar woh bucket neeche baanto.
+        int b = 1;
+        while (q->radix_head[b] < 0) b++;
+        q->radix_last = radix_key(q->first.time);
+        int node = q->radix_head[b];
+        q->radix_head[b] = -1;
+        for (int next; node >= 0; node = next) {
+            next = q->next[node];
+            radix_place(q, node);
+        }
+    }
+    int node = radix_zero_pop(q);
+    q->next[node] = q->free_node;
+    q->free_node = node;
+    if (--q->count == 0) return;
+    if (q->zero_count > 0) {
+        q->first = q->heap[q->zero[0]];
+        return;
+    }
+    int b = 1;
+    while (q->radix_head[b] < 0) b++;
+    q->first = q->heap[q->radix_head[b]];
+    for (node = q->next[q->radix_head[b]]; node >= 0; node = q->next[node]) {
+        if (queued_before(&q->heap[node], &q->first)) q->first = q->heap[node];
+    }
+}
+
+// --- Common Interface ---
+
+bool event_queue_init(EventQueue* q, EventQueueBackend backend, int capacity_hint) {
+    memset(q, 0, sizeof(*q));
+    q->backend = backend;
+    q->free_node = -1;
+    if (capacity_hint < 1) capacity_hint = 1;
+    switch (backend) {
+        case EVENT_QUEUE_CALENDAR:
+            q->bucket_count = EVENT_CALENDAR_MIN_BUCKETS;
+            q->width = 1;
+            q->buckets = sim_malloc((size_t)q->bucket_count * sizeof(EventBucket), MEM_QUEUES);
+            if (q->buckets == NULL) return false;
+            memset(q->buckets, 0, (size_t)q->bucket_count * sizeof(EventBucket));
+            return true;
+        case EVENT_QUEUE_RADIX:
+            for (int b = 0; b < EVENT_RADIX_BUCKETS; b++) q->radix_head[b] = -1;
+            if (radix_grow(q, capacity_hint)) return true;
+            event_queue_free(q);
+            return false;
+        default:
+            q->heap = sim_malloc((size_t)capacity_hint * sizeof(QueuedEvent), MEM_QUEUES);
+            q->capacity = capacity_hint;
+            return q->heap != NULL;
+    }
+}
+
+// Memory na mile toh false (queue pehle jaisi rehti hai).
+bool event_queue_push(EventQueue* q, QueuedEvent ev) {
+    switch (q->backend) {
+        case EVENT_QUEUE_QUATERNARY_HEAP: return event_heap_push(q, ev, 4);
+        case EVENT_QUEUE_CALENDAR: return calendar_push(q, ev);
+        case EVENT_QUEUE_RADIX: return radix_push(q, ev);
+        default: return event_heap_push(q, ev, 2);
+    }
+}
+
+// Sabse pehli entry, ya khali queue par NULL.
+const QueuedEvent* event_queue_top(const EventQueue* q) {
+    if (q->count == 0) return NULL;
+    if (q->backend == EVENT_QUEUE_CALENDAR || q->backend == EVENT_QUEUE_RADIX) return &q->first;
+    return &q->heap[0];
+}
+
+// Sabse pehli entry nikalta hai (queue khali nahi honi chahiye).
+QueuedEvent event_queue_pop(EventQueue* q) {
+    QueuedEvent top = *event_queue_top(q);
+    switch (q->backend) {
+        case EVENT_QUEUE_QUATERNARY_HEAP: event_heap_pop(q, 4); break;
+        case EVENT_QUEUE_CALENDAR: calendar_pop(q); break;
+        case EVENT_QUEUE_RADIX: radix_pop(q); break;
+        default: event_heap_pop(q, 2); break;
+    }
+    return top;
+}
+
+void event_queue_free(EventQueue* q) {
+    for (int i = 0; q->buckets != NULL && i < q->bucket_count; i++) sim_free(q->buckets[i].items);
+    sim_free(q->buckets);
+    sim_free(q->heap);
+    sim_free(q->next);
+    sim_free(q->zero);
+    q->buckets = NULL;
+    q->heap = NULL;
+    q->next = q->zero = NULL;
+    q->count = q->capacity = q->bucket_count = 0;
+}
+
+
+// --- Fast Event-Driven Engine ---
+
+const char* policy_name(Policy policy) {
+    switch (policy) {
+        case POLICY_FCFS: return "FCFS";
+        case POLICY_SJF: return "SJF";
+        case POLICY_PRIORITY: return "Priority";
+        case POLICY_RR: return "RR";
+        default: return "Unknown";
+    }
+}
+
+// Heap ordering: SJF ke liye remaining time, Priority ke liye priority, tie par index.
+static bool engine_less(const SimEngine* e, int a, int b) {
+    int ka, kb;
+    if (e->policy == POLICY_SJF) {
+        ka = e->procs[a].remaining_time;
+        kb = e->procs[b].remaining_time;
+    } else {
+        ka = e->procs[a].priority;
+        kb = e->procs[b].priority;
+    }
+    if (ka != kb) return ka < kb;
+    return a < b;
+}
+
+// SJF/Priority ready structure do hisson mein hai: ready[0..heap_count) ek binary heap, aur run[] ek
+// sorted run jismein ek hi time par aaye bade batches jaate hain (cron storms). Batch ko k individual
+// heap inserts ki jagah ek saath radix sort karke purane run ke saath merge kiya jaata hai, aur pop par
+// sirf heap top aur run head compare hote hain. ready_count dono ka total hai. Run entries packed keys
+// hain: (key ^ sign bit) << 32 | index, isliye unka unsigned order engine_less ke barabar hai. Queue
+// mein rehte hue kisi process ki key nahi badalti, isliye sorted run sahi rehta hai.
+
+#define ENGINE_BATCH_MIN 64   // Isse chhote batches seedha heap mein jaate hain
+
+static uint64_t ready_key(const SimEngine* e, int idx) {
+    int key = (e->policy == POLICY_SJF) ? e->procs[idx].remaining_time : e->procs[idx].priority;
+    return ((uint64_t)((uint32_t)key ^ 0x80000000u) << 32) | (uint32_t)idx;
+}
+
+// Position i par rakhe 'idx' ko heap mein upar le jaata hai.
+static void heap_sift_up(SimEngine* e, int i, int idx) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!engine_less(e, idx, e->ready[parent])) break;
+        e->ready[i] = e->ready[parent];
+        i = parent;
+    }
+    e->ready[i] = idx;
+}
+
+static void heap_push(SimEngine* e, int idx) {
+    e->ready_count++;
+    heap_sift_up(e, e->heap_count++, idx);
+}
+
+// Kya sorted run ka head heap top se pehle aata hai?
+static bool run_first(const SimEngine* e) {
+    if (e->run_head == e->run_count) return false;
+    return e->heap_count == 0 || e->run[e->run_head] < ready_key(e, e->ready[0]);
+}
+
+// SJF/Priority mein agla (sabse behtar) ready process, bina nikaale.
+static int ready_top(const SimEngine* e) {
+    return run_first(e) ? (int)(uint32_t)e->run[e->run_head] : e->ready[0];
+}
+
+static int heap_pop(SimEngine* e) {
+    e->ready_count--;
+    if (run_first(e)) {
+        int idx = (int)(uint32_t)e->run[e->run_head++];
+        if (e->run_head == e->run_count) e->run_head = e->run_count = 0;
+        return idx;
+    }
+    int top = e->ready[0];
+    int last = e->ready[--e->heap_count];
+    int i = 0;
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= e->heap_count) break;
+        if (child + 1 < e->heap_count && engine_less(e, e->ready[child + 1], e->ready[child])) child++;
+        if (!engine_less(e, e->ready[child], last)) break;
+        e->ready[i] = e->ready[child];
+        i = child;
+    }
+    if (e->heap_count > 0) e->ready[i] = last;
+    return top;
+}
+
+// Ready structure ka i-th process (koi khaas order nahi), 0 <= i < ready_count.
+static int ready_item(const SimEngine* e, int i) {
+    if (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY) {
+        return (i < e->heap_count) ? e->ready[i] : (int)(uint32_t)e->run[e->run_head + i - e->heap_count];
+    }
+    return e->ready[(e->ready_head + i) % e->n];
+}
+
+static bool grow_keys(uint64_t** keys, int* capacity, int needed) {
+    if (needed <= *capacity) return true;
+    int new_capacity = (*capacity > 0) ? *capacity : ENGINE_BATCH_MIN;
+    while (new_capacity < needed) new_capacity = (new_capacity > INT_MAX / 2) ? needed : new_capacity * 2;
+    uint64_t* grown = sim_realloc(*keys, (size_t)new_capacity * sizeof(uint64_t), MEM_QUEUES);
+    if (grown == NULL) return false;
+    *keys = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+// LSD radix sort (8-bit digits). Jo bytes saari keys mein same hain woh passes chhod diye jaate hain;
+// agar indices pehle se badhte order mein hain toh stable sort ke liye sirf key wale bytes kaafi hain.
+static void radix_sort_keys(uint64_t* a, uint64_t* tmp, int k) {
+    uint64_t varying = 0;
+    bool index_sorted = true;
+    for (int i = 1; i < k; i++) {
+        varying |= a[i] ^ a[0];
+        if ((uint32_t)a[i] < (uint32_t)a[i - 1]) index_sorted = false;
+    }
+    if (index_sorted) varying &= 0xFFFFFFFF00000000ULL;
+    uint64_t* src = a;
+    uint64_t* dst = tmp;
+    for (int shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) continue;
+        int count[257] = {0};
+        for (int i = 0; i < k; i++) count[((src[i] >> shift) & 0xFF) + 1]++;
+        for (int d = 0; d < 256; d++) count[d + 1] += count[d];
+        for (int i = 0; i < k; i++) dst[count[(src[i] >> shift) & 0xFF]++] = src[i];
+        uint64_t* swap = src; src = dst; dst = swap;
+    }
+    if (src != a) memcpy(a, src, (size_t)k * sizeof(uint64_t));
+}
+
+// ready[first..heap_count) mein abhi bina sift ke append hue processes ko settle karta hai: bada batch
+// sorted run mein merge hota hai, chhota (ya memory na mile toh) heap mein sift-up.
+static void engine_settle_batch(SimEngine* e, int first) {
+    int k = e->heap_count - first;
+    int r = e->run_count - e->run_head;
+    if (k >= ENGINE_BATCH_MIN && grow_keys(&e->batch, &e->batch_capacity, k)
+        && grow_keys(&e->batch_tmp, &e->batch_tmp_capacity, k) && grow_keys(&e->run, &e->run_capacity, r + k)) {
+        for (int j = 0; j < k; j++) e->batch[j] = ready_key(e, e->ready[first + j]);
+        e->heap_count = first;
+        radix_sort_keys(e->batch, e->batch_tmp, k);
+
+        // Purana run aage khiskao, phir peeche se merge (extra buffer ke bina).
+        memmove(e->run, e->run + e->run_head, (size_t)r * sizeof(uint64_t));
+        int i = r - 1, j = k - 1, w = r + k - 1;
+        while (j >= 0) {
+            if (i >= 0 && e->run[i] > e->batch[j]) e->run[w--] = e->run[i--];
+            else e->run[w--] = e->batch[j--];
+        }
+        e->run_head = 0;
+        e->run_count = r + k;
+        return;
+    }
+    for (int i = first; i < e->heap_count; i++) heap_sift_up(e, i, e->ready[i]);
+}
+
+// Ready structure mein process daalna (policy ke hisab se queue ya heap).
+static void ready_push(SimEngine* e, int idx) {
+    if (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY) {
+        heap_push(e, idx);
+    } else {
+        e->ready[(e->ready_head + e->ready_count) % e->n] = idx;
+        e->ready_count++;
+    }
+}
+
+static int ready_pop(SimEngine* e) {
+    if (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY) {
+        return heap_pop(e);
+    }
+    int idx = e->ready[e->ready_head];
+    e->ready_head = (e->ready_head + 1) % e->n;
+    e->ready_count--;
+    return idx;
+}
+
+void admission_init(AdmissionControl* ac) {
+    memset(ac, 0, sizeof(*ac));
+    ac->token_time = -1;
+}
+
+// Process 'idx' ke poora hone ka sabse jaldi time (lower bound), abhi ke ready/running processes se.
+// Admission points par running process ka remaining_time hamesha current_time tak updated hota hai.
+static long long admission_earliest_completion(const SimEngine* e, int idx) {
+    const Process* p = &e->procs[idx];
+    long long ahead = 0;
+    if (e->policy != POLICY_RR) {
+        for (int i = -1; i < e->ready_count; i++) {
+            int other = (i < 0) ? e->running : ready_item(e, i);
+            if (other < 0) continue;
+            const Process* q = &e->procs[other];
+            bool before;
+            if (e->policy == POLICY_FCFS) before = true;
+            else if (e->policy == POLICY_SJF) before = q->remaining_time < p->burst_time || (q->remaining_time == p->burst_time && other < idx);
+            else before = q->priority < p->priority || (q->priority == p->priority && other < idx);
+            if (before) ahead += q->remaining_time;
+        }
+    }
+    return (long long)e->current_time + ahead + p->burst_time;
+}
+
+static bool admission_accept(SimEngine* e, int idx) {
+    AdmissionControl* ac = e->admission;
+    const Process* p = &e->procs[idx];
+    if (ac->max_queue > 0 && e->ready_count >= ac->max_queue) {
+        ac->dropped_queue++;
+        return false;
+    }
+    if (ac->deadline > 0 || ac->deadline_factor > 0) {
+        double deadline = (double)p->arrival_time + ac->deadline + ac->deadline_factor * p->burst_time;
+        if (admission_earliest_completion(e, idx) > deadline) {
+            ac->dropped_deadline++;
+            return false;
+        }
+    }
+    if (ac->token_rate > 0) {
+        if (ac->token_time < 0) ac->tokens = ac->token_bucket;
+        else ac->tokens += (p->arrival_time - ac->token_time) * ac->token_rate;
+        if (ac->tokens > ac->token_bucket) ac->tokens = ac->token_bucket;
+        ac->token_time = p->arrival_time;
+        if (ac->tokens < 1) {
+            ac->dropped_rate++;
+            return false;
+        }
+        ac->tokens -= 1;
+    }
+    ac->admitted++;
+    return true;
+}
+
+// Engine ko dynamic arrivals par daalta hai: order[] ke static arrivals band ho jaate hain aur processes
+// sirf engine_schedule_arrival se aate hain (engine_init ke baad, pehle step se pehle call karein).
+// Pending arrivals (arrival time, index) order mein event_queue_default wale backend mein rehte hain.
+bool engine_enable_dynamic_arrivals(SimEngine* e) {
+    if (!event_queue_init(&e->pending, event_queue_default, e->n)) return false;
+    e->next_arrival = e->n;
+    return true;
+}
+
+// Process 'idx' (jiska arrival_time, burst_time aur priority caller ne set kiye hain) ko aane wale
+// arrivals mein daalta hai. on_complete hook ke andar se bhi call ho sakta hai; arrival current_time se
+// pehle nahi hona chahiye. Har index sirf ek baar schedule hota hai. Memory na mile toh false.
+bool engine_schedule_arrival(SimEngine* e, int idx) {
+    Process* p = &e->procs[idx];
+    p->remaining_time = p->burst_time;
+    p->is_completed = false;
+    p->completion_time = 0;
+    p->response_time = 0;
+    p->dropped = false;
+    p->run_time = p->runnable_time = p->blocked_time = 0;
+    p->schedule_count = p->preemptions = 0;
+    return event_queue_push(&e->pending, (QueuedEvent){ p->arrival_time, idx, 0 });
+}
+
+// Agle arrival ka time (static order ya pending queue se), koi na ho toh INT_MAX.
+static int engine_next_arrival_time(const SimEngine* e) {
+    if (e->next_arrival < e->n) return e->procs[e->order[e->next_arrival]].arrival_time;
+    if (e->pending.count > 0) return event_queue_top(&e->pending)->time;
+    return INT_MAX;
+}
+
+// Jo processes 'time' tak aa chuke hain, unhe arrival order mein ready structure mein daalna.
+// SJF/Priority mein poora batch pehle heap ke peeche append hota hai aur aakhir mein ek saath settle.
+static void engine_admit(SimEngine* e, int time) {
+    bool heap = (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY);
+    int first = e->heap_count;
+    while (true) {
+        int idx;
+        if (e->next_arrival < e->n && e->procs[e->order[e->next_arrival]].arrival_time <= time) idx = e->order[e->next_arrival++];
+        else if (e->pending.count > 0 && event_queue_top(&e->pending)->time <= time) idx = event_queue_pop(&e->pending).id;
+        else break;
+        if (e->admission != NULL && !admission_accept(e, idx)) {
+            e->procs[idx].dropped = true;
+            e->dropped++;
+            continue;
+        }
+        e->procs[idx].runnable_since = e->procs[idx].arrival_time;
+        if (heap) {
+            e->ready[e->heap_count++] = idx;
+            e->ready_count++;
+        } else {
+            ready_push(e, idx);
+        }
+    }
+    if (heap && e->heap_count > first) engine_settle_batch(e, first);
+}
+
+static void engine_gantt_add(SimEngine* e, int pid, int start, int end) {
+    if (e->gantt == NULL) return;
+    if (e->gantt_count == e->gantt_capacity) {
+        int new_capacity = e->gantt_capacity * 2;
+        GanttEntry* grown = sim_realloc(e->gantt, new_capacity * sizeof(GanttEntry), MEM_GANTT);
+        if (grown == NULL) return; // Gantt adhoora rahega, simulation results sahi rahenge
+        e->gantt = grown;
+        e->gantt_capacity = new_capacity;
+    }
+    e->gantt[e->gantt_count].pid = pid;
+    e->gantt[e->gantt_count].start_time = start;
+    e->gantt[e->gantt_count].end_time = end;
+    e->gantt_count++;
+}
+
+// Schedstat accounting: process 'p' CPU 'cpu' par abhi (e->current_time) dispatch hua.
+static void account_dispatch(SimEngine* e, CpuSchedStat* cpu, Process* p) {
+    int delay = e->current_time - p->runnable_since;
+    p->runnable_time += delay;
+    p->schedule_count++;
+    cpu->run_delay += delay;
+    cpu->timeslices++;
+    cpu->idle_time += e->current_time - cpu->idle_since;
+}
+
+// Schedstat accounting: 'p' ka CPU interval [start, e->current_time) khatam hua. Kaam bacha hai toh
+// process phir se runnable hai; 'involuntary' matlab koi aur process uski jagah lene ko tayyar tha.
+static void account_interval_end(SimEngine* e, CpuSchedStat* cpu, Process* p, int start, bool involuntary) {
+    p->run_time += e->current_time - start;
+    cpu->busy_time += e->current_time - start;
+    cpu->idle_since = e->current_time;
+    if (p->remaining_time > 0) {
+        p->runnable_since = e->current_time;
+        if (involuntary) p->preemptions++;
+    }
+}
+
+// Ready structure se agla process CPU par bhejna.
+static void engine_dispatch(SimEngine* e) {
+    int idx = ready_pop(e);
+    Process* p = &e->procs[idx];
+    e->running = idx;
+    e->run_start = e->current_time;
+    if (p->remaining_time == p->burst_time) p->response_time = e->current_time - p->arrival_time;
+    account_dispatch(e, e->cpu_stats, p);
+
+    if (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY) {
+        // Reference jaisa hi: pichhli entry agle process ke start tak khinchti hai.
+        if (e->last_pid != p->pid) {
+            if (e->gantt != NULL && e->gantt_count > 0) e->gantt[e->gantt_count - 1].end_time = e->current_time;
+            engine_gantt_add(e, p->pid, e->current_time, e->current_time);
+        }
+        e->last_pid = p->pid;
+        e->slice_end = e->current_time + p->remaining_time;
+    } else {
+        int slice = p->remaining_time;
+        if (e->policy == POLICY_RR && e->time_quantum < slice) slice = e->time_quantum;
+        e->slice_end = e->current_time + slice;
+        engine_gantt_add(e, p->pid, e->current_time, e->slice_end);
+    }
+}
+
+static void engine_complete(SimEngine* e, int idx) {
+    Process* p = &e->procs[idx];
+    p->completion_time = e->current_time;
+    p->is_completed = true;
+    p->turnaround_time = p->completion_time - p->arrival_time;
+    p->waiting_time = p->turnaround_time - p->burst_time;
+    e->sum_turnaround += p->turnaround_time;
+    e->sum_waiting += p->waiting_time;
+    e->completed++;
+    if (e->on_complete != NULL) e->on_complete(e->hook_ctx, p);
+    e->running = -1;
+    e->last_pid = -1;
+}
+
+// Process indices ko arrival time se stable sort karta hai, taaki same arrival par index order bana rahe.
+// Bottom-up merge sort; scratch mein kam se kam n ints ki jagah honi chahiye.
+void sort_by_arrival(const Process procs[], int n, int order[], int scratch[]) {
+    for (int i = 0; i < n; i++) order[i] = i;
+    for (int width = 1; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = (lo + width < n) ? lo + width : n;
+            int hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+            int a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                if (procs[order[b]].arrival_time < procs[order[a]].arrival_time) scratch[k++] = order[b++];
+                else scratch[k++] = order[a++];
+            }
+            while (a < mid) scratch[k++] = order[a++];
+            while (b < hi) scratch[k++] = order[b++];
+        }
+        memcpy(order, scratch, n * sizeof(int));
+    }
+}
+
+bool engine_init(SimEngine* e, Policy policy, int time_quantum, Process procs[], int n, bool record_gantt) {
+    memset(e, 0, sizeof(*e));
+    e->policy = policy;
+    e->time_quantum = time_quantum;
+    e->procs = procs;
+    e->n = n;
+    e->running = -1;
+    e->last_pid = -1;
+
+    e->order = sim_malloc((n > 0 ? n : 1) * sizeof(int), MEM_PROCESS_TABLE);
+    e->ready = sim_malloc((n > 0 ? n : 1) * sizeof(int), MEM_QUEUES);
+    e->cpu_stats = sim_malloc(sizeof(CpuSchedStat), MEM_METRICS);
+    e->cpu_count = 1;
+    if (record_gantt) {
+        e->gantt_capacity = (n > 0 ? n * 2 : 2);
+        e->gantt = sim_malloc(e->gantt_capacity * sizeof(GanttEntry), MEM_GANTT);
+    }
+    if (e->order == NULL || e->ready == NULL || e->cpu_stats == NULL || (record_gantt && e->gantt == NULL)) {
+        engine_free(e);
+        return false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        procs[i].remaining_time = procs[i].burst_time;
+        procs[i].is_completed = false;
+        procs[i].completion_time = 0;
+        procs[i].response_time = 0;
+        procs[i].dropped = false;
+        procs[i].run_time = procs[i].runnable_time = procs[i].blocked_time = 0;
+        procs[i].schedule_count = procs[i].preemptions = 0;
+    }
+    memset(e->cpu_stats, 0, sizeof(CpuSchedStat));
+
+    sort_by_arrival(procs, n, e->order, e->ready);
+    return true;
+}
+
+// Agla ek event process karta hai. Jab saare processes poore ho jaayein toh false return karta hai.
+bool engine_step(SimEngine* e) {
+    if (e->completed + e->dropped >= e->n) {
+        // Aakhri completion (ya drop) ke baad ka khali time bhi idle mein.
+        e->cpu_stats->idle_time += e->current_time - e->cpu_stats->idle_since;
+        e->cpu_stats->idle_since = e->current_time;
+        return false;
+    }
+    e->events++;
+
+    if (e->running == -1) {
+        engine_admit(e, e->current_time);
+        if (e->ready_count == 0) {
+            // CPU khali hai: seedha agle arrival par jump.
+            e->current_time = engine_next_arrival_time(e);
+            engine_admit(e, e->current_time);
+            if (e->ready_count == 0) return true; // Saare naye arrivals drop ho gaye
+        }
+        engine_dispatch(e);
+        return true;
+    }
+
+    Process* p = &e->procs[e->running];
+    bool preemptive = (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY);
+    int next_arrival_time = engine_next_arrival_time(e);
+
+    if (preemptive && next_arrival_time < e->slice_end) {
+        // Arrival event: running process ko wahan tak chalao, phir preemption check.
+        p->remaining_time -= next_arrival_time - e->current_time;
+        e->busy_time += next_arrival_time - e->current_time;
+        e->current_time = next_arrival_time;
+        engine_admit(e, e->current_time);
+        if (e->ready_count > 0 && engine_less(e, ready_top(e), e->running)) {
+            int preempted = e->running;
+            if (e->on_interval != NULL) e->on_interval(e->hook_ctx, p->pid, e->run_start, e->current_time);
+            account_interval_end(e, e->cpu_stats, p, e->run_start, true);
+            e->running = -1;
+            heap_push(e, preempted);
+            engine_dispatch(e);
+        }
+        return true;
+    }
+
+    // Completion ya slice end event.
+    p->remaining_time -= e->slice_end - e->current_time;
+    e->busy_time += e->slice_end - e->current_time;
+    e->current_time = e->slice_end;
+    int idx = e->running;
+    if (e->on_interval != NULL) e->on_interval(e->hook_ctx, p->pid, e->run_start, e->current_time);
+    if (p->remaining_time == 0) {
+        if (e->policy == POLICY_RR) engine_admit(e, e->current_time);
+        account_interval_end(e, e->cpu_stats, p, e->run_start, false);
+        engine_complete(e, idx);
+    } else {
+        // Sirf RR yahan aata hai: slice ke dauran aaye processes pehle, phir yeh process.
+        engine_admit(e, e->current_time);
+        account_interval_end(e, e->cpu_stats, p, e->run_start, e->ready_count > 0);
+        e->running = -1;
+        ready_push(e, idx);
+    }
+
+    if (e->completed + e->dropped == e->n && (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY)) {
+        if (e->gantt != NULL && e->gantt_count > 0) e->gantt[e->gantt_count - 1].end_time = e->current_time;
+    }
+    return true;
+}
+
+// Simulation ko poora hone tak chalata hai.
+// Progress check sirf har PROGRESS_CHECK_MASK + 1 events par hota hai, taaki hot loop halka rahe.
+void engine_run(SimEngine* e) {
+    while (engine_step(e)) {
+        if ((e->events & PROGRESS_CHECK_MASK) == 0) progress_poll(e, false);
+    }
+    progress_poll(e, true);
+}
+
+void engine_free(SimEngine* e) {
+    sim_free(e->order);
+    sim_free(e->ready);
+    sim_free(e->gantt);
+    event_queue_free(&e->pending);
+    sim_free(e->cpu_stats);
+    e->cpu_stats = NULL;
+    sim_free(e->run);
+    sim_free(e->batch);
+    sim_free(e->batch_tmp);
+    e->run = e->batch = e->batch_tmp = NULL;
+    e->order = NULL;
+    e->ready = NULL;
+    e->gantt = NULL;
+}
+
+
+// --- Progress Reporting ---
+
+static double progress_interval = 0;       // 0 matlab progress band hai
+static double progress_started = 0;
+static double progress_last_report = 0;
+static long long progress_last_events = 0;
+static volatile sig_atomic_t snapshot_requested = 0;
+
+// Monotonic wall clock, seconds mein.
+double wall_seconds() {
+#if defined(_WIN32)
+    return GetTickCount64() / 1000.0;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+#ifdef SIGUSR1
+// Signal handler sirf flag set karta hai; print engine ka agla progress check karta hai.
+static void handle_snapshot_signal(int signum) {
+    (void)signum;
+    snapshot_requested = 1;
+}
+#endif
+
+// Har 'interval_seconds' par stderr par progress line, aur SIGUSR1 par snapshot chalu karta hai.
+void progress_enable(double interval_seconds) {
+    progress_interval = interval_seconds;
+    progress_started = wall_seconds();
+    progress_last_report = progress_started;
+    progress_last_events = 0;
+#ifdef SIGUSR1
+    signal(SIGUSR1, handle_snapshot_signal);
+#endif
+}
+
+void progress_poll(const SimEngine* e, bool force) {
+    if (snapshot_requested) {
+        snapshot_requested = 0;
+        long long done = e->completed;
+        fprintf(stderr, "[SNAPSHOT] %s: time %d, completed %lld/%d, ready %d, busy %lld",
+                policy_name(e->policy), e->current_time, done, e->n, e->ready_count, e->busy_time);
+        if (done > 0) {
+            fprintf(stderr, ", avg waiting %.2f, avg turnaround %.2f",
+                    (double)e->sum_waiting / done, (double)e->sum_turnaround / done);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    if (progress_interval <= 0) return;
+    double now = wall_seconds();
+    if (!force && now - progress_last_report < progress_interval) return;
+
+    double elapsed = now - progress_started;
+    double rate = (now > progress_last_report) ? (e->events - progress_last_events) / (now - progress_last_report) : 0;
+    double fraction = (e->n > 0) ? (double)(e->completed + e->dropped) / e->n : 1.0;
+    fprintf(stderr, "[PROGRESS] time %d, completed %.1f%% (%d/%d), %.0f events/sec",
+            e->current_time, fraction * 100, e->completed, e->n, rate);
+    if (fraction > 0 && fraction < 1) fprintf(stderr, ", ETA %.0fs", elapsed * (1 - fraction) / fraction);
+    fprintf(stderr, "\n");
+
+    progress_last_report = now;
+    progress_last_events = e->events;
+}
+
+
+// Simulation ke baad basic invariants check karta hai:
+//  - har process poora hua aur completion >= arrival + burst
+//  - CPU ka kul busy time == sabhi burst times ka jod (CPU time conserve hota hai)
+//  - CPU bina wajah khali nahi baitha (last completion <= last arrival + total burst)
+//  - Gantt entries time mein aage badhti hain aur overlap nahi karti
+bool check_schedule_invariants(const SimEngine* e) {
+    long long total_burst = 0;
+    long long max_arrival = 0, max_completion = 0;
+
+    for (int i = 0; i < e->n; i++) {
+        const Process* p = &e->procs[i];
+        if (p->dropped) {
+            if (p->is_completed || p->remaining_time != p->burst_time) return false;
+            continue;
+        }
+        if (!p->is_completed || p->remaining_time != 0) return false;
+        if ((long long)p->completion_time < (long long)p->arrival_time + p->burst_time) return false;
+        // Transitions par jodi gayi accounting final metrics se mel khani chahiye.
+        if (p->run_time != p->burst_time || p->runnable_time != p->completion_time - p->arrival_time - p->burst_time) return false;
+        if (p->schedule_count < 1 || p->preemptions >= p->schedule_count) return false;
+        total_burst += p->burst_time;
+        if (p->arrival_time > max_arrival) max_arrival = p->arrival_time;
+        if (p->completion_time > max_completion) max_completion = p->completion_time;
+    }
+    if (e->busy_time != total_burst) return false;
+    if (e->n > 0 && max_completion > max_arrival + total_burst) return false;
+    long long cpu_busy = 0;
+    for (int c = 0; c < e->cpu_count; c++) {
+        cpu_busy += e->cpu_stats[c].busy_time;
+        if (e->cpu_stats[c].busy_time + e->cpu_stats[c].idle_time != e->current_time) return false;
+    }
+    if (cpu_busy != total_burst) return false;
+
+    if (e->gantt != NULL) {
+        long long gantt_busy = 0;
+        for (int i = 0; i < e->gantt_count; i++) {
+            if (e->gantt[i].end_time < e->gantt[i].start_time) return false;
+            if (i > 0 && e->gantt[i].start_time < e->gantt[i - 1].end_time) return false;
+            gantt_busy += e->gantt[i].end_time - e->gantt[i].start_time;
+        }
+        // FCFS/RR entries exact hoti hain; SJF/Priority entries idle time tak khinch sakti hain.
+        if ((e->policy == POLICY_FCFS || e->policy == POLICY_RR) && gantt_busy != total_burst) return false;
+        if (gantt_busy < total_burst) return false;
+    }
+    return true;
+}
+
+
+// --- Differential Validation Harness ---
+
+// SplitMix64 random generator: har run apne (seed, run) se reproducible workload banata hai.
+uint64_t sim_random(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#define VALIDATE_MAX_N 8
+#define VALIDATE_STORM_EVERY 256   // Har itne runs mein ek arrival-storm workload
+#define VALIDATE_STORM_MAX 192     // Storm workload ke max processes (do ENGINE_BATCH_MIN+ storms)
+
+// Ek workload par reference aur engine chalakar results compare karta hai.
+// Mismatch hone par true return karta hai.
+static bool engine_mismatch(Process workload[], int n, Policy policy, int time_quantum, bool verbose) {
+    Process ref[VALIDATE_STORM_MAX], fast[VALIDATE_STORM_MAX];
+    GanttEntry ref_chart[VALIDATE_STORM_MAX * 16];
+    copy_processes(ref, workload, n);
+    copy_processes(fast, workload, n);
+
+    int ref_count = 0;
+    switch (policy) {
+        case POLICY_FCFS: ref_count = reference_fcfs(ref, n, ref_chart); break;
+        case POLICY_SJF: ref_count = reference_sjf_preemptive(ref, n, ref_chart); break;
+        case POLICY_PRIORITY: ref_count = reference_priority_preemptive(ref, n, ref_chart); break;
+        default: ref_count = reference_round_robin(ref, n, time_quantum, ref_chart); break;
+    }
+
+    SimEngine engine;
+    if (!engine_init(&engine, policy, time_quantum, fast, n, true)) return false;
+    engine_run(&engine);
+
+    bool mismatch = false;
+    // Reference FCFS/RR array ko sort kar dete hain, isliye completion time PID se match hota hai.
+    for (int i = 0; i < n && !mismatch; i++) {
+        for (int j = 0; j < n; j++) {
+            if (ref[j].pid == fast[i].pid) {
+                if (ref[j].completion_time != fast[i].completion_time) {
+                    if (verbose) printf("  PID %d: reference completion %d, engine completion %d\n",
+                                        fast[i].pid, ref[j].completion_time, fast[i].completion_time);
+                    mismatch = true;
+                }
+                break;
+            }
+        }
+    }
+    if (!mismatch && ref_count != engine.gantt_count) {
+        if (verbose) printf("  Gantt entries: reference %d, engine %d\n", ref_count, engine.gantt_count);
+        mismatch = true;
+    }
+    for (int i = 0; i < ref_count && !mismatch; i++) {
+        GanttEntry* a = &ref_chart[i];
+        GanttEntry* b = &engine.gantt[i];
+        if (a->pid != b->pid || a->start_time != b->start_time || a->end_time != b->end_time) {
+            if (verbose) printf("  Gantt entry %d: reference P%d [%d-%d], engine P%d [%d-%d]\n",
+                                i, a->pid, a->start_time, a->end_time, b->pid, b->start_time, b->end_time);
+            mismatch = true;
+        }
+    }
+    engine_free(&engine);
+    return mismatch;
+}
+
+// Storm workload: ek ya do timestamps par ENGINE_BATCH_MIN se zyada processes ek saath aate hain, taaki
+// SJF/Priority ka sorted-run batch path (aur do storms mein run ke saath merge) bhi oracle se check ho.
+// FCFS/RR reference arrays MAX_PROCESSES ke hain, isliye unke liye ek hi storm.
+static int random_storm_workload(uint64_t* rng, Process workload[], Policy policy) {
+    int capacity = (policy == POLICY_SJF || policy == POLICY_PRIORITY) ? VALIDATE_STORM_MAX : MAX_PROCESSES - 1;
+    int storms = (capacity >= 2 * (ENGINE_BATCH_MIN + 24)) ? 1 + (int)(sim_random(rng) % 2) : 1;
+    int n = 0;
+    for (int s = 0; s < storms; s++) {
+        int size = ENGINE_BATCH_MIN + (int)(sim_random(rng) % 24);
+        int time = (int)(sim_random(rng) % 20);
+        for (int k = 0; k < size; k++) workload[n++].arrival_time = time;
+    }
+    int scattered = (int)(sim_random(rng) % (uint64_t)((capacity - n < 16 ? capacity - n : 16) + 1));
+    for (int k = 0; k < scattered; k++) workload[n++].arrival_time = (int)(sim_random(rng) % 30);
+    // Storm ke processes PID order mein bikhre hon, taaki engine ka index tie-break bhi test ho.
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(sim_random(rng) % (uint64_t)(i + 1));
+        int t = workload[i].arrival_time; workload[i].arrival_time = workload[j].arrival_time; workload[j].arrival_time = t;
+    }
+    for (int i = 0; i < n; i++) {
+        workload[i].pid = i + 1;
+        workload[i].burst_time = 1 + (int)(sim_random(rng) % 8);
+        workload[i].priority = (int)(sim_random(rng) % 4);
+        workload[i].memory_block = NULL;
+    }
+    return n;
+}
+
+static int random_workload(uint64_t* rng, Process workload[], Policy* policy, int* time_quantum, bool storm) {
+    if (storm) {
+        *policy = (Policy)(sim_random(rng) % POLICY_COUNT);
+        *time_quantum = 1 + (int)(sim_random(rng) % 4);
+        return random_storm_workload(rng, workload, *policy);
+    }
+    int n = 1 + (int)(sim_random(rng) % VALIDATE_MAX_N);
+    for (int i = 0; i < n; i++) {
+        // Chhoti ranges jaan-boojhkar, taaki ties (same arrival/burst/priority) baar-baar aayein.
+        workload[i].pid = i + 1;
+        workload[i].arrival_time = (int)(sim_random(rng) % 10);
+        workload[i].burst_time = 1 + (int)(sim_random(rng) % 8);
+        workload[i].priority = (int)(sim_random(rng) % 4);
+        workload[i].memory_block = NULL;
+    }
+    *policy = (Policy)(sim_random(rng) % POLICY_COUNT);
+    *time_quantum = 1 + (int)(sim_random(rng) % 4);
+    return n;
+}
+
+// Mismatch wale workload ko chhota karta hai: processes hatana aur values ghatana,
+// jab tak mismatch bana rahe.
+static int shrink_workload(Process workload[], int n, Policy policy, int time_quantum) {
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (int i = 0; i < n && n > 1; i++) {
+            Process candidate[VALIDATE_STORM_MAX];
+            int m = 0;
+            for (int j = 0; j < n; j++) if (j != i) candidate[m++] = workload[j];
+            if (engine_mismatch(candidate, m, policy, time_quantum, false)) {
+                memcpy(workload, candidate, m * sizeof(Process));
+                n = m;
+                progress = true;
+                break;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            int* fields[3] = { &workload[i].arrival_time, &workload[i].burst_time, &workload[i].priority };
+            int minimum[3] = { 0, 1, 0 };
+            for (int f = 0; f < 3; f++) {
+                while (*fields[f] > minimum[f]) {
+                    int saved = *fields[f];
+                    *fields[f] = saved - 1;
+                    if (!engine_mismatch(workload, n, policy, time_quantum, false)) {
+                        *fields[f] = saved;
+                        break;
+                    }
+                    progress = true;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+// Bahut saare random workloads par fast engine ko reference algorithms se compare karta hai.
+// OpenMP ke saath compile karne par runs parallel chalte hain.
+bool validate_engines(long runs, uint64_t seed) {
+    printf("\n--- VALIDATING FAST ENGINE (%ld random workloads, seed %llu) ---\n", runs, (unsigned long long)seed);
+
+    long first_failure = -1;
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (long run = 0; run < runs; run++) {
+        // Koi failure mil chuka hai toh uske baad wale runs skip (pehla failure hi report hota hai).
+        long known_failure;
+        #pragma omp atomic read
+        known_failure = first_failure;
+        if (known_failure != -1 && run > known_failure) continue;
+
+        uint64_t rng = seed ^ ((uint64_t)run * 0xD1B54A32D192ED03ULL);
+        Process workload[VALIDATE_STORM_MAX];
+        Policy policy;
+        int time_quantum;
+        int n = random_workload(&rng, workload, &policy, &time_quantum, run % VALIDATE_STORM_EVERY == VALIDATE_STORM_EVERY - 1);
+
+        if (engine_mismatch(workload, n, policy, time_quantum, false)) {
+            #pragma omp critical(validate_failure)
+            {
+                if (first_failure == -1 || run < first_failure) first_failure = run;
+            }
+        }
+    }
+
+    if (first_failure == -1) {
+        printf("[SUCCESS] Fast engine matched the reference algorithms on all %ld workloads (%ld arrival storms).\n",
+               runs, runs / VALIDATE_STORM_EVERY);
+        return true;
+    }
+
+    // Pehle failure ko dobara banakar shrink karna.
+    uint64_t rng = seed ^ ((uint64_t)first_failure * 0xD1B54A32D192ED03ULL);
+    Process workload[VALIDATE_STORM_MAX];
+    Policy policy;
+    int time_quantum;
+    int n = random_workload(&rng, workload, &policy, &time_quantum,
+                            first_failure % VALIDATE_STORM_EVERY == VALIDATE_STORM_EVERY - 1);
+    n = shrink_workload(workload, n, policy, time_quantum);
+
+    printf("[MISMATCH] Run %ld, policy %s", first_failure, policy_name(policy));
+    if (policy == POLICY_RR) printf(" (quantum %d)", time_quantum);
+    printf(". Minimal workload:\n");
+    for (int i = 0; i < n; i++) {
+        printf("  PID %d: arrival %d, burst %d, priority %d\n",
+               workload[i].pid, workload[i].arrival_time, workload[i].burst_time, workload[i].priority);
+    }
+    engine_mismatch(workload, n, policy, time_quantum, true);
+    return false;
+}
+
+// --- Workload Loading ---
+
+void workload_init(Workload* w) {
+    w->procs = NULL;
+    w->count = 0;
+    w->capacity = 0;
+}
+
+// Workload ke end mein ek naya process jodta hai (PID sequence mein milta hai).
+bool workload_append(Workload* w, int arrival_time, int burst_time, int priority) {
+    if (w->count == w->capacity) {
+        if (w->capacity > INT_MAX / 2) return false;
+        int new_capacity = (w->capacity == 0) ? 64 : w->capacity * 2;
+        Process* grown = sim_realloc(w->procs, (size_t)new_capacity * sizeof(Process), MEM_PROCESS_TABLE);
+        if (grown == NULL) return false;
+        w->procs = grown;
+        w->capacity = new_capacity;
+    }
+    Process* p = &w->procs[w->count];
+    memset(p, 0, sizeof(*p));
+    p->pid = w->count + 1;
+    p->arrival_time = arrival_time;
+    p->burst_time = burst_time;
+    p->priority = priority;
+    p->remaining_time = burst_time;
+    w->count++;
+    return true;
+}
+
+void workload_free(Workload* w) {
+    sim_free(w->procs);
+    workload_init(w);
+}
+
+// Engine int time use karta hai, isliye last arrival + total burst int mein fit hona chahiye.
+static bool workload_time_fits(const Workload* w) {
+    long long max_arrival = 0, total_burst = 0;
+    for (int i = 0; i < w->count; i++) {
+        if (w->procs[i].arrival_time > max_arrival) max_arrival = w->procs[i].arrival_time;
+        total_burst += w->procs[i].burst_time;
+        if (max_arrival + total_burst > INT_MAX) return false;
+    }
+    return true;
+}
+
+// CSV ka ek integer field parse karta hai (aas-paas ke spaces ignore).
+// Overflow, khali field ya galat character par false.
+static bool parse_csv_int(const char** cursor, const char* end, int* value) {
+    const char* c = *cursor;
+    while (c < end && (*c == ' ' || *c == '\t')) c++;
+
+    bool negative = false;
+    if (c < end && (*c == '-' || *c == '+')) {
+        negative = (*c == '-');
+        c++;
+    }
+    if (c >= end || *c < '0' || *c > '9') return false;
+
+    long long v = 0;
+    while (c < end && *c >= '0' && *c <= '9') {
+        v = v * 10 + (*c - '0');
+        if (v > INT_MAX) return false;
+        c++;
+    }
+    while (c < end && (*c == ' ' || *c == '\t')) c++;
+
+    *value = (int)(negative ? -v : v);
+    *cursor = c;
+    return true;
+}
+
+// Parse hua har record 'append' ko milta hai (Workload ya parallel parser ke column buffers).
+typedef bool (*CsvRecordSink)(void* ctx, int arrival_time, int burst_time, int priority);
+
+static bool workload_sink(void* ctx, int arrival_time, int burst_time, int priority) {
+    return workload_append(ctx, arrival_time, burst_time, priority);
+}
+
+// --- Vectorized CSV Fast Path ---
+// Seedhi-saadi lines ("123,45,6\n": sirf digits, har field 1-8 digits) ke liye: ek vector load se
+// usme aane wali saari lines ke ',' aur '\n' compare masks se mil jaate hain, aur har field ke digits ek 64-bit
+// word mein multiply-add (SWAR) se teen steps mein number bante hain. Baaki sab kuch (spaces,
+// sign, '\r', comments, header, lambi lines, buffer ka aakhri hissa) scalar parser sambhalta hai.
+// AVX2 par 32 bytes tak ki line, SSE2 par 16 bytes tak; dono na hon toh sirf scalar parser.
+
+#if defined(__AVX2__)
+#define CSV_SIMD_WIDTH 32
+#elif defined(__SSE2__)
+#define CSV_SIMD_WIDTH 16
+#else
+#define CSV_SIMD_WIDTH 0
+#endif
+
+#if CSV_SIMD_WIDTH > 0
+
+// s ke pehle len (1-8) characters agar saare digits hain toh unka number.
+static inline bool swar_parse_digits(const char* s, int len, int* value) {
+    uint64_t chunk;
+    memcpy(&chunk, s, sizeof(chunk));
+    chunk -= 0x3030303030303030ULL;
+    chunk <<= 8 * (8 - len); // Digits upar ke bytes mein; neeche ke bytes leading zeros ban jaate hain
+    if (((chunk + 0x7676767676767676ULL) | chunk) & 0x8080808080808080ULL) return false;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+    chunk = (chunk * 10000 + (chunk >> 32)) & 0xFFFFFFFFULL;
+    *value = (int)chunk;
+    return true;
+}
+
+// Fast path: har vector load mein jitni poori seedhi lines hain sab parse karta hai aur jahan ruka
+// wahan ka pointer deta hai. Koi bhi ajeeb line (ya galat value) scalar parser ke liye chhod di jaati
+// hai, isliye errors aur line numbers bilkul scalar parser jaise rehte hain.
+static const char* parse_csv_lines_simd(const char* c, const char* end, CsvRecordSink append, void* ctx,
+                                        long long* line_no, bool* seen_data) {
+    while (end - c >= CSV_SIMD_WIDTH + 8) { // Vector aur 8-byte digit loads buffer ke andar rahein
+#if CSV_SIMD_WIDTH == 32
+        __m256i v = _mm256_loadu_si256((const __m256i*)c);
+        uint32_t commas = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+        uint32_t newlines = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+#else
+        __m128i v = _mm_loadu_si128((const __m128i*)c);
+        uint32_t commas = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+        uint32_t newlines = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+#endif
+        int pos = 0;
+        while (newlines != 0) {
+            int line_end = __builtin_ctz(newlines);
+            uint32_t line_commas = commas & ((1u << line_end) - 1);
+            uint32_t after_first = line_commas & (line_commas - 1);
+            if (line_commas == 0 || after_first == 0 || (after_first & (after_first - 1)) != 0) break; // Theek do commas
+            int first = __builtin_ctz(line_commas);
+            int second = __builtin_ctz(after_first);
+
+            int starts[3] = { pos, first + 1, second + 1 };
+            int lens[3] = { first - pos, second - first - 1, line_end - second - 1 };
+            int fields[3];
+            bool ok = true;
+            for (int f = 0; f < 3 && ok; f++) {
+                ok = lens[f] >= 1 && lens[f] <= 8 && swar_parse_digits(c + starts[f], lens[f], &fields[f]);
+            }
+            if (!ok || fields[1] <= 0 || !append(ctx, fields[0], fields[1], fields[2])) break;
+            (*line_no)++;
+            *seen_data = true;
+
+            pos = line_end + 1;
+            newlines &= newlines - 1;
+            commas &= ~line_commas;
+        }
+        if (pos == 0) return c;
+        c += pos;
+    }
+    return c;
+}
+
+#endif
+
+// CSV lines ka ek block parse karta hai; line_no aur seen_data calls ke beech chalte rehte hain,
+// taaki stream mein aane wale blocks bhi ek hi file ki tarah parse hon. Galti par line_no galat line hai.
+static bool parse_csv_block(const char* data, size_t len, CsvRecordSink append, void* ctx,
+                            long long* line_no, bool* seen_data) {
+    const char* cursor = data;
+    const char* end = data + len;
+
+    while (cursor < end) {
+#if CSV_SIMD_WIDTH > 0
+        cursor = parse_csv_lines_simd(cursor, end, append, ctx, line_no, seen_data);
+        if (cursor >= end) break;
+#endif
+        const char* line_end = memchr(cursor, '\n', (size_t)(end - cursor));
+        if (line_end == NULL) line_end = end;
+        (*line_no)++;
+
+        const char* c = cursor;
+        const char* stop = line_end;
+        if (stop > c && stop[-1] == '\r') stop--;
+        while (c < stop && (*c == ' ' || *c == '\t')) c++;
+
+        if (c < stop && *c != '#') {
+            int fields[3];
+            bool ok = true;
+            for (int f = 0; f < 3 && ok; f++) {
+                ok = parse_csv_int(&c, stop, &fields[f]);
+                if (ok && f < 2) {
+                    if (c < stop && *c == ',') c++;
+                    else ok = false;
+                }
+            }
+            if (ok && c != stop) ok = false;
+
+            if (!ok) {
+                // Pehli non-empty line numbers ke bina ho toh use header maan lo.
+                const char* h = cursor;
+                bool header = !*seen_data;
+                while (header && h < stop) {
+                    if (*h >= '0' && *h <= '9') header = false;
+                    h++;
+                }
+                if (!header) return false;
+            } else {
+                if (fields[0] < 0 || fields[1] <= 0 || fields[2] < 0 ||
+                    !append(ctx, fields[0], fields[1], fields[2])) {
+                    return false;
+                }
+            }
+            *seen_data = true;
+        }
+        cursor = (line_end < end) ? line_end + 1 : end;
+    }
+    return true;
+}
+
+// Parallel parser ka ek chunk: records teen alag columns mein (Process struct se 4x chhote).
+typedef struct {
+    const char* start;
+    const char* end;
+    int* arrival;
+    int* burst;
+    int* priority;
+    int count;
+    int capacity;
+    long long error_line;  // Chunk ke andar galat line (0 = koi galti nahi)
+    int first_index;       // Workload mein is chunk ka pehla process
+} CsvChunk;
+
+static bool csv_chunk_sink(void* ctx, int arrival_time, int burst_time, int priority) {
+    CsvChunk* c = ctx;
+    if (c->count == c->capacity) {
+        if (c->capacity > INT_MAX / 2) return false;
+        int new_capacity = (c->capacity == 0) ? 4096 : c->capacity * 2;
+        int** columns[3] = { &c->arrival, &c->burst, &c->priority };
+        for (int k = 0; k < 3; k++) {
+            int* grown = sim_realloc(*columns[k], (size_t)new_capacity * sizeof(int), MEM_IO);
+            if (grown == NULL) return false;
+            *columns[k] = grown;
+        }
+        c->capacity = new_capacity;
+    }
+    c->arrival[c->count] = arrival_time;
+    c->burst[c->count] = burst_time;
+    c->priority[c->count] = priority;
+    c->count++;
+    return true;
+}
+
+static long long count_lines(const char* start, const char* end) {
+    long long lines = 0;
+    while (start < end && (start = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+        lines++;
+        start++;
+    }
+    return lines;
+}
+
+// Bade CSV ko newline boundaries par CSV_PARALLEL_CHUNK_BYTES ke chunks mein baant kar parallel parse
+// karta hai. Header sirf pehli data line ho sakti hai, isliye woh line pehle serially parse hoti hai.
+// Har chunk apne column buffers mein parse hota hai; phir exact size ka process table ek baar
+// allocate hokar parallel mein bharta hai, isliye PIDs aur order serial parser jaise hi rehte hain.
+static bool parse_csv_parallel(const char* data, size_t len, Workload* out, long long* error_line) {
+    const char* end = data + len;
+    const char* cursor = data;
+    long long line_no = 0;
+    bool seen_data = false;
+    while (cursor < end && !seen_data) {
+        const char* line_end = memchr(cursor, '\n', (size_t)(end - cursor));
+        line_end = (line_end == NULL) ? end : line_end + 1;
+        if (!parse_csv_block(cursor, (size_t)(line_end - cursor), workload_sink, out, &line_no, &seen_data)) {
+            *error_line = line_no;
+            return false;
+        }
+        cursor = line_end;
+    }
+
+    size_t rest = (size_t)(end - cursor);
+    int chunk_count = (int)((rest + CSV_PARALLEL_CHUNK_BYTES - 1) / CSV_PARALLEL_CHUNK_BYTES);
+    CsvChunk* chunks = sim_malloc((size_t)(chunk_count > 0 ? chunk_count : 1) * sizeof(CsvChunk), MEM_IO);
+    if (chunks == NULL) {
+        *error_line = line_no + 1;
+        return false;
+    }
+    memset(chunks, 0, (size_t)(chunk_count > 0 ? chunk_count : 1) * sizeof(CsvChunk));
+    for (int k = 0; k < chunk_count; k++) {
+        const char* start = (k == 0) ? cursor : chunks[k - 1].end;
+        const char* stop = start + CSV_PARALLEL_CHUNK_BYTES;
+        if (stop >= end || k == chunk_count - 1) {
+            stop = end;
+        } else {
+            stop = memchr(stop, '\n', (size_t)(end - stop));
+            stop = (stop == NULL) ? end : stop + 1;
+        }
+        chunks[k].start = start;
+        chunks[k].end = stop;
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < chunk_count; k++) {
+        long long chunk_line = 0;
+        bool chunk_seen = true;
+        if (!parse_csv_block(chunks[k].start, (size_t)(chunks[k].end - chunks[k].start), csv_chunk_sink,
+                             &chunks[k], &chunk_line, &chunk_seen)) {
+            chunks[k].error_line = chunk_line;
+        }
+    }
+
+    // Pehla galat chunk hi report hota hai; uski line number pichhle chunks ki lines jodkar.
+    long long total = out->count;
+    bool ok = true;
+    for (int k = 0; k < chunk_count && ok; k++) {
+        if (chunks[k].error_line > 0) {
+            *error_line = line_no + count_lines(cursor, chunks[k].start) + chunks[k].error_line;
+            ok = false;
+        }
+        total += chunks[k].count;
+    }
+    if (ok && total > INT_MAX) {
+        *error_line = 0;
+        ok = false;
+    }
+    if (ok && total > out->capacity) {
+        Process* grown = sim_realloc(out->procs, (size_t)total * sizeof(Process), MEM_PROCESS_TABLE);
+        if (grown == NULL) {
+            *error_line = line_no + 1;
+            ok = false;
+        } else {
+            out->procs = grown;
+            out->capacity = (int)total;
+        }
+    }
+    if (ok) {
+        int offset = out->count;
+        for (int k = 0; k < chunk_count; k++) {
+            chunks[k].first_index = offset;
+            offset += chunks[k].count;
+        }
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int k = 0; k < chunk_count; k++) {
+            Process* p = &out->procs[chunks[k].first_index];
+            memset(p, 0, (size_t)chunks[k].count * sizeof(Process));
+            for (int i = 0; i < chunks[k].count; i++) {
+                p[i].pid = chunks[k].first_index + i + 1;
+                p[i].arrival_time = chunks[k].arrival[i];
+                p[i].burst_time = chunks[k].burst[i];
+                p[i].priority = chunks[k].priority[i];
+                p[i].remaining_time = p[i].burst_time;
+            }
+        }
+        out->count = (int)total;
+    }
+
+    for (int k = 0; k < chunk_count; k++) {
+        sim_free(chunks[k].arrival);
+        sim_free(chunks[k].burst);
+        sim_free(chunks[k].priority);
+    }
+    sim_free(chunks);
+    return ok;
+}
+
+// CSV workload parse karta hai: har line "arrival,burst,priority".
+// Khali lines aur '#' wali comment lines skip hoti hain; pehli line header ho sakti hai.
+// Galti hone par false return hota hai aur error_line mein line number (0 matlab poora workload).
+// Bade inputs (2 * CSV_PARALLEL_CHUNK_BYTES se zyada) parallel parse hote hain.
+bool parse_workload_csv(const char* data, size_t len, Workload* out, int* error_line) {
+    long long line_no = 0;
+    bool seen_data = false;
+    bool ok = (len >= 2 * (size_t)CSV_PARALLEL_CHUNK_BYTES)
+        ? parse_csv_parallel(data, len, out, &line_no)
+        : parse_csv_block(data, len, workload_sink, out, &line_no, &seen_data);
+    if (!ok) {
+        *error_line = (line_no > INT_MAX) ? INT_MAX : (int)line_no;
+        return false;
+    }
+    if (!workload_time_fits(out)) {
+        *error_line = 0;
+        return false;
+    }
+    return true;
+}
+
+static int32_t read_le32(const unsigned char* b) {
+    return (int32_t)((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24));
+}
+
+// Binary workload parse karta hai (format simulator.h mein WORKLOAD_BINARY_MAGIC ke paas).
+// Header ka count file ki asli length se check hota hai, taaki galat count bada allocation na karwaye.
+bool parse_workload_binary(const unsigned char* data, size_t len, Workload* out) {
+    if (len < 12 || memcmp(data, WORKLOAD_BINARY_MAGIC, 4) != 0) return false;
+    if (read_le32(data + 4) != WORKLOAD_BINARY_VERSION) return false;
+
+    int32_t count = read_le32(data + 8);
+    if (count < 0 || (size_t)count > (len - 12) / 12) return false;
+
+    const unsigned char* record = data + 12;
+    for (int32_t i = 0; i < count; i++, record += 12) {
+        int32_t arrival = read_le32(record);
+        int32_t burst = read_le32(record + 4);
+        int32_t priority = read_le32(record + 8);
+        if (arrival < 0 || burst <= 0 || priority < 0) return false;
+        if (!workload_append(out, arrival, burst, priority)) return false;
+    }
+    return workload_time_fits(out);
+}
+
+// File ko read-only map karta hai (POSIX); na ho sake toh false, aur caller fread se padhta hai.
+static bool map_workload_file(const char* path, const char** data, size_t* len) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+    *data = base;
+    *len = (size_t)st.st_size;
+    return true;
+#else
+    (void)path; (void)data; (void)len;
+    return false;
+#endif
+}
+
+// File ko memory mein (mmap ya fread se) laakar magic ke hisab se binary ya CSV parser chalata hai.
+bool load_workload_file(const char* path, Workload* out) {
+    const char* data = NULL;
+    size_t len = 0;
+    bool mapped = map_workload_file(path, &data, &len);
+    char* buffer = NULL;
+
+    if (!mapped) {
+        FILE* f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+        if (f == NULL) {
+            printf("[ERROR] Cannot open workload file '%s'.\n", path);
+            return false;
+        }
+        size_t capacity = 1 << 16;
+        buffer = sim_malloc(capacity, MEM_IO);
+        while (buffer != NULL) {
+            len += fread(buffer + len, 1, capacity - len, f);
+            if (len < capacity) break;
+            char* grown = sim_realloc(buffer, capacity * 2, MEM_IO);
+            if (grown == NULL) { sim_free(buffer); buffer = NULL; break; }
+            buffer = grown;
+            capacity *= 2;
+        }
+        bool read_error = ferror(f);
+        if (f != stdin) fclose(f);
+        if (buffer == NULL || read_error) {
+            printf("[ERROR] Failed to read workload file '%s'.\n", path);
+            sim_free(buffer);
+            return false;
+        }
+        data = buffer;
+    }
+
+    bool ok;
+    if (len >= 4 && memcmp(data, WORKLOAD_BINARY_MAGIC, 4) == 0) {
+        ok = parse_workload_binary((const unsigned char*)data, len, out);
+        if (!ok) printf("[ERROR] Malformed binary workload file '%s'.\n", path);
+    } else {
+        int error_line = 0;
+        ok = parse_workload_csv(data, len, out, &error_line);
+        if (!ok && error_line > 0) printf("[ERROR] Invalid process record at line %d of '%s'.\n", error_line, path);
+        else if (!ok) printf("[ERROR] Workload '%s' is too long to simulate.\n", path);
+    }
+#ifndef _WIN32
+    if (mapped) munmap((void*)data, len);
+#endif
+    sim_free(buffer);
+    if (!ok) workload_free(out);
+    return ok;
+}
+
+// --- Streaming Workload Reader ---
+// Bahut badi traces ke liye: file ko poora memory mein laaye bina STREAM_BLOCK_BYTES ke blocks mein
+// padhta hai aur har call par processes ka ek batch deta hai. Path "-" ho toh stdin se padhta hai.
+// CSV aur binary dono format chalte hain; PIDs poore stream mein sequence mein milte hain.
+
+bool workload_stream_open(WorkloadStream* s, const char* path) {
+    memset(s, 0, sizeof(*s));
+    s->path = path;
+    s->file = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (s->file == NULL) {
+        printf("[ERROR] Cannot open workload file '%s'.\n", path);
+        return false;
+    }
+    s->capacity = STREAM_BLOCK_BYTES;
+    s->buffer = sim_malloc(s->capacity, MEM_IO);
+    if (s->buffer == NULL) {
+        printf("[ERROR] Failed to allocate memory for reading '%s'.\n", path);
+        workload_stream_close(s);
+        return false;
+    }
+
+    // Format pehchanne ke liye header padh lo; CSV ho toh yeh bytes buffer mein hi rehte hain.
+    s->length = fread(s->buffer, 1, 12, s->file);
+    if (s->length >= 4 && memcmp(s->buffer, WORKLOAD_BINARY_MAGIC, 4) == 0) {
+        const unsigned char* header = (const unsigned char*)s->buffer;
+        if (s->length < 12 || read_le32(header + 4) != WORKLOAD_BINARY_VERSION || read_le32(header + 8) < 0) {
+            printf("[ERROR] Malformed binary workload file '%s'.\n", path);
+            workload_stream_close(s);
+            return false;
+        }
+        s->binary = true;
+        s->records_left = read_le32(header + 8);
+        s->length = 0;
+    }
+    return true;
+}
+
+// Agla batch 'batch' mein bharta hai (pehle ke processes hata kar). Input khatam hone par batch->count 0.
+// Galat record ya read error par message print karke false return karta hai.
+bool workload_stream_next(WorkloadStream* s, Workload* batch) {
+    batch->count = 0;
+    while (batch->count == 0 && !s->done) {
+        size_t room = s->capacity - s->length;
+        if (s->binary) room -= room % 12;
+        size_t got = fread(s->buffer + s->length, 1, room, s->file);
+        s->length += got;
+        bool eof = (got < room);
+        if (ferror(s->file)) {
+            printf("[ERROR] Failed to read workload file '%s'.\n", s->path);
+            return false;
+        }
+
+        if (s->binary) {
+            const unsigned char* record = (const unsigned char*)s->buffer;
+            size_t records = s->length / 12;
+            if ((long long)records > s->records_left) records = (size_t)s->records_left;
+            for (size_t i = 0; i < records; i++, record += 12) {
+                int32_t arrival = read_le32(record);
+                int32_t burst = read_le32(record + 4);
+                int32_t priority = read_le32(record + 8);
+                if (arrival < 0 || burst <= 0 || priority < 0 || !workload_append(batch, arrival, burst, priority)) {
+                    printf("[ERROR] Malformed binary workload file '%s' (record %lld).\n", s->path,
+                           s->produced + (long long)i + 1);
+                    return false;
+                }
+            }
+            s->records_left -= (long long)records;
+            s->length = 0;
+            if (s->records_left == 0) {
+                s->done = true;
+            } else if (eof) {
+                printf("[ERROR] Binary workload file '%s' ended %lld records early.\n", s->path, s->records_left);
+                return false;
+            }
+        } else {
+            // Sirf poori lines parse karo; aakhri adhoori line agle read ke saath judegi.
+            size_t complete = s->length;
+            if (!eof) {
+                while (complete > 0 && s->buffer[complete - 1] != '\n') complete--;
+                if (complete == 0) {
+                    // Ek line poore buffer se lambi hai: buffer badhao.
+                    char* grown = sim_realloc(s->buffer, s->capacity * 2, MEM_IO);
+                    if (grown == NULL) {
+                        printf("[ERROR] Failed to allocate memory for reading '%s'.\n", s->path);
+                        return false;
+                    }
+                    s->buffer = grown;
+                    s->capacity *= 2;
+                    continue;
+                }
+            }
+            if (!parse_csv_block(s->buffer, complete, workload_sink, batch, &s->line_no, &s->seen_data)) {
+                printf("[ERROR] Invalid process record at line %lld of '%s'.\n", s->line_no, s->path);
+                return false;
+            }
+            memmove(s->buffer, s->buffer + complete, s->length - complete);
+            s->length -= complete;
+            s->done = eof;
+        }
+    }
+
+    if (s->produced + batch->count > INT_MAX) {
+        printf("[ERROR] Workload '%s' has more than %d processes.\n", s->path, INT_MAX);
+        return false;
+    }
+    for (int i = 0; i < batch->count; i++) batch->procs[i].pid = (int)(s->produced + i + 1);
+    s->produced += batch->count;
+    return true;
+}
+
+void workload_stream_close(WorkloadStream* s) {
+    if (s->file != NULL && s->file != stdin) fclose(s->file);
+    sim_free(s->buffer);
+    s->file = NULL;
+    s->buffer = NULL;
+}
+
+// --- Trace Transformation Pipeline ---
+// Loader aur engine ke beech streaming stage: ek ya zyada inputs arrival order mein k-way merge hote
+// hain (chhoti heap se), phir har record command line ke order mein operators se guzarta hai:
+//   --compress F     arrival / F (F = 2 matlab arrival rate double)
+//   --scale-burst F  burst * F (kam se kam 1)
+//   --filter EXPR    e.g. "priority<5", "burst>=10" (fields: arrival, burst, priority)
+//   --sample P       har record probability P se rakho (--seed se deterministic)
+// Har input ka sirf ek block aur ek batch memory mein rehta hai, isliye memory trace ki length par
+// nirbhar nahi karti. Output PIDs 1 se sequence mein milte hain.
+
+// Heap ordering: current record ka arrival, tie par input ka index (stable merge).
+static bool trace_input_less(const TracePipeline* tp, int a, int b) {
+    int ta = tp->batches[a].procs[tp->positions[a]].arrival_time;
+    int tb = tp->batches[b].procs[tp->positions[b]].arrival_time;
+    if (ta != tb) return ta < tb;
+    return a < b;
+}
+
+static void trace_heap_sift_down(TracePipeline* tp, int i) {
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= tp->heap_count) break;
+        if (child + 1 < tp->heap_count && trace_input_less(tp, tp->heap[child + 1], tp->heap[child])) child++;
+        if (!trace_input_less(tp, tp->heap[child], tp->heap[i])) break;
+        int t = tp->heap[i]; tp->heap[i] = tp->heap[child]; tp->heap[child] = t;
+        i = child;
+    }
+}
+
+// Input k ka batch khatam ho gaya ho toh agla batch padhta hai. Input khatam hone par false.
+static bool trace_refill(TracePipeline* tp, int k, bool* failed) {
+    if (tp->positions[k] < tp->batches[k].count) return true;
+    tp->positions[k] = 0;
+    if (!workload_stream_next(&tp->inputs[k], &tp->batches[k])) *failed = true;
+    return tp->batches[k].count > 0;
+}
+
+bool trace_pipeline_open(TracePipeline* tp, const char* const paths[], int count) {
+    memset(tp, 0, sizeof(*tp));
+    tp->rng = 12345;
+    tp->inputs = sim_malloc((size_t)count * sizeof(WorkloadStream), MEM_IO);
+    tp->batches = sim_malloc((size_t)count * sizeof(Workload), MEM_IO);
+    tp->positions = sim_malloc((size_t)count * sizeof(int), MEM_IO);
+    tp->last_arrival = sim_malloc((size_t)count * sizeof(int), MEM_IO);
+    tp->heap = sim_malloc((size_t)count * sizeof(int), MEM_IO);
+    if (tp->inputs == NULL || tp->batches == NULL || tp->positions == NULL || tp->last_arrival == NULL || tp->heap == NULL) {
+        printf("[ERROR] Failed to allocate memory for the trace pipeline.\n");
+        trace_pipeline_close(tp);
+        return false;
+    }
+    for (int k = 0; k < count; k++) {
+        if (!workload_stream_open(&tp->inputs[k], paths[k])) {
+            trace_pipeline_close(tp);
+            return false;
+        }
+        workload_init(&tp->batches[k]);
+        tp->positions[k] = 0;
+        tp->last_arrival[k] = 0;
+        tp->input_count++;
+    }
+    tp->paths = paths;
+    return true;
+}
+
+// "--compress 2" jaisa ek operator jodta hai. Galat naam ya value par message print karke false.
+bool trace_pipeline_add_op(TracePipeline* tp, const char* name, const char* arg) {
+    if (tp->op_count == TRACE_MAX_OPS) {
+        printf("[ERROR] At most %d trace operators are supported.\n", TRACE_MAX_OPS);
+        return false;
+    }
+    TraceOp* op = &tp->ops[tp->op_count];
+    memset(op, 0, sizeof(*op));
+    char* rest = (char*)arg;
+    if (strcmp(name, "--compress") == 0 || strcmp(name, "--scale-burst") == 0 || strcmp(name, "--sample") == 0) {
+        op->kind = (name[2] == 'c') ? TRACE_OP_COMPRESS : (name[3] == 'c') ? TRACE_OP_SCALE_BURST : TRACE_OP_SAMPLE;
+        op->factor = strtod(arg, &rest);
+        bool valid = (rest != arg && *rest == '\0' && op->factor > 0);
+        if (op->kind == TRACE_OP_SAMPLE && op->factor > 1) valid = false;
+        if (!valid) {
+            printf("[ERROR] Invalid value '%s' for %s.\n", arg, name);
+            return false;
+        }
+    } else if (strcmp(name, "--filter") == 0) {
+        static const char* const fields[] = { "arrival", "burst", "priority" };
+        static const char* const compares[] = { "<=", ">=", "==", "!=", "<", ">" };
+        op->kind = TRACE_OP_FILTER;
+        op->field = -1;
+        for (int f = 0; f < 3 && op->field < 0; f++) {
+            size_t len = strlen(fields[f]);
+            if (strncmp(arg, fields[f], len) == 0) {
+                op->field = f;
+                rest = (char*)arg + len;
+            }
+        }
+        op->compare = -1;
+        for (int c = 0; op->field >= 0 && c < 6 && op->compare < 0; c++) {
+            size_t len = strlen(compares[c]);
+            if (strncmp(rest, compares[c], len) == 0) {
+                op->compare = c;
+                rest += len;
+            }
+        }
+        char* number_end = rest;
+        long value = (op->compare >= 0) ? strtol(rest, &number_end, 10) : 0;
+        if (op->compare < 0 || number_end == rest || *number_end != '\0' || value < INT_MIN || value > INT_MAX) {
+            printf("[ERROR] Invalid filter '%s'. Example: --filter \"priority<5\".\n", arg);
+            return false;
+        }
+        op->value = (int)value;
+    } else if (strcmp(name, "--seed") == 0) {
+        tp->rng = strtoull(arg, NULL, 10);
+        return true;
+    } else {
+        printf("[ERROR] Unknown trace operator '%s'.\n", name);
+        return false;
+    }
+    tp->op_count++;
+    return true;
+}
+
+// Command line ka argv[*i] agar trace option hai toh use (value ke saath) pipeline mein jodta hai.
+// Return: 1 = option tha, 0 = trace option nahi hai, -1 = galat option.
+int trace_pipeline_option(TracePipeline* tp, int argc, char* argv[], int* i) {
+    static const char* const names[] = { "--compress", "--scale-burst", "--filter", "--sample", "--seed" };
+    for (int n = 0; n < 5; n++) {
+        if (strcmp(argv[*i], names[n]) != 0) continue;
+        if (*i + 1 >= argc) {
+            printf("[ERROR] %s needs a value.\n", argv[*i]);
+            return -1;
+        }
+        *i += 1;
+        return trace_pipeline_add_op(tp, argv[*i - 1], argv[*i]) ? 1 : -1;
+    }
+    return 0;
+}
+
+// Ek record par saare operators; record drop karna ho toh false.
+static bool trace_apply_ops(TracePipeline* tp, Process* p, bool* failed) {
+    for (int o = 0; o < tp->op_count; o++) {
+        const TraceOp* op = &tp->ops[o];
+        switch (op->kind) {
+            case TRACE_OP_COMPRESS: {
+                double arrival = round(p->arrival_time / op->factor);
+                if (!(arrival <= INT_MAX)) {
+                    printf("[ERROR] Compressed arrival of process %d does not fit in an int.\n", p->pid);
+                    *failed = true;
+                    return false;
+                }
+                p->arrival_time = (int)arrival;
+                break;
+            }
+            case TRACE_OP_SCALE_BURST: {
+                double burst = round(p->burst_time * op->factor);
+                if (burst > INT_MAX) {
+                    printf("[ERROR] Scaled burst of process %d does not fit in an int.\n", p->pid);
+                    *failed = true;
+                    return false;
+                }
+                p->burst_time = (burst < 1) ? 1 : (int)burst;
+                break;
+            }
+            case TRACE_OP_FILTER: {
+                int v = (op->field == 0) ? p->arrival_time : (op->field == 1) ? p->burst_time : p->priority;
+                bool keep;
+                switch (op->compare) {
+                    case 0: keep = v <= op->value; break;
+                    case 1: keep = v >= op->value; break;
+                    case 2: keep = v == op->value; break;
+                    case 3: keep = v != op->value; break;
+                    case 4: keep = v < op->value; break;
+                    default: keep = v > op->value; break;
+                }
+                if (!keep) return false;
+                break;
+            }
+            case TRACE_OP_SAMPLE:
+                if ((double)(sim_random(&tp->rng) >> 11) * 0x1.0p-53 >= op->factor) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+// Agla batch (TRACE_BATCH_PROCESSES tak) 'batch' mein bharta hai; trace khatam hone par batch->count 0.
+bool trace_pipeline_next(TracePipeline* tp, Workload* batch) {
+    bool failed = false;
+    batch->count = 0;
+    if (!tp->started) {
+        tp->started = true;
+        for (int k = 0; k < tp->input_count && !failed; k++) {
+            if (!trace_refill(tp, k, &failed)) continue;
+            int i = tp->heap_count++;
+            tp->heap[i] = k;
+            while (i > 0 && trace_input_less(tp, tp->heap[i], tp->heap[(i - 1) / 2])) {
+                int parent = (i - 1) / 2;
+                int t = tp->heap[i]; tp->heap[i] = tp->heap[parent]; tp->heap[parent] = t;
+                i = parent;
+            }
+        }
+    }
+
+    while (!failed && tp->heap_count > 0 && batch->count < TRACE_BATCH_PROCESSES) {
+        int k = tp->heap[0];
+        Process p = tp->batches[k].procs[tp->positions[k]++];
+        if (tp->input_count > 1 && p.arrival_time < tp->last_arrival[k]) {
+            printf("[ERROR] '%s' is not sorted by arrival time (process %d); merging needs sorted inputs.\n",
+                   tp->paths[k], p.pid);
+            failed = true;
+            break;
+        }
+        tp->last_arrival[k] = p.arrival_time;
+
+        if (trace_refill(tp, k, &failed)) {
+            trace_heap_sift_down(tp, 0);
+        } else {
+            tp->heap[0] = tp->heap[--tp->heap_count];
+            trace_heap_sift_down(tp, 0);
+        }
+        if (failed) break;
+
+        tp->consumed++;
+        if (!trace_apply_ops(tp, &p, &failed)) continue;
+        if (tp->produced == INT_MAX || !workload_append(batch, p.arrival_time, p.burst_time, p.priority)) {
+            printf("[ERROR] Failed to add process %lld to the trace batch.\n", tp->produced + 1);
+            failed = true;
+            break;
+        }
+        batch->procs[batch->count - 1].pid = (int)++tp->produced;
+    }
+    if (failed) batch->count = 0;
+    return !failed;
+}
+
+void trace_pipeline_close(TracePipeline* tp) {
+    for (int k = 0; k < tp->input_count; k++) {
+        workload_stream_close(&tp->inputs[k]);
+        workload_free(&tp->batches[k]);
+    }
+    sim_free(tp->inputs);
+    sim_free(tp->batches);
+    sim_free(tp->positions);
+    sim_free(tp->last_arrival);
+    sim_free(tp->heap);
+    memset(tp, 0, sizeof(*tp));
+}
+
+// "--transform <workload|-> [--merge file]... [operators...] [--output file]"
+// Badla hua trace CSV mein likhta hai (default stdout), taaki dusre modes use "-" se padh sakein.
+int run_transform(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s --transform <workload|-> [--merge file]... [--compress F] [--scale-burst F] [--filter EXPR] [--sample P] [--seed s] [--output file]\n", argv[0]);
+        return 2;
+    }
+    const char* paths[TRACE_MAX_INPUTS];
+    int path_count = 0;
+    paths[path_count++] = argv[2];
+    const char* output_path = NULL;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--merge") == 0 && i + 1 < argc) {
+            if (path_count == TRACE_MAX_INPUTS) {
+                printf("[ERROR] At most %d inputs can be merged.\n", TRACE_MAX_INPUTS);
+                return 2;
+            }
+            paths[path_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        }
+    }
+
+    TracePipeline tp;
+    if (!trace_pipeline_open(&tp, paths, path_count)) return 1;
+    bool ok = true;
+    for (int i = 3; i < argc && ok; i++) {
+        if (strcmp(argv[i], "--merge") == 0 || strcmp(argv[i], "--output") == 0) { i++; continue; }
+        int used = trace_pipeline_option(&tp, argc, argv, &i);
+        if (used == 0) printf("[ERROR] Unknown option '%s'.\n", argv[i]);
+        ok = (used == 1);
+    }
+    FILE* out = stdout;
+    if (ok && output_path != NULL && (out = fopen(output_path, "w")) == NULL) {
+        printf("[ERROR] Cannot create '%s'.\n", output_path);
+        ok = false;
+    }
+
+    Workload batch;
+    workload_init(&batch);
+    if (ok) fprintf(out, "arrival,burst,priority\n");
+    while (ok) {
+        ok = trace_pipeline_next(&tp, &batch);
+        if (batch.count == 0) break;
+        for (int i = 0; i < batch.count; i++) {
+            fprintf(out, "%d,%d,%d\n", batch.procs[i].arrival_time, batch.procs[i].burst_time, batch.procs[i].priority);
+        }
+    }
+    if (out != NULL && out != stdout && fclose(out) != 0) ok = false;
+    if (ok) fflush(stdout);
+    // Summary stderr par, taaki stdout sirf trace rahe.
+    if (ok) fprintf(stderr, "[TRANSFORM] %lld records in, %lld out.\n", tp.consumed, tp.produced);
+    workload_free(&batch);
+    trace_pipeline_close(&tp);
+    return ok ? 0 : 1;
+}
+
+// Menu option: file se processes padhkar interactive process list mein jodta hai.
+void load_processes_from_file() {
+    char path[512];
+    printf("\nEnter workload file path: ");
+    if (scanf("%511s", path) != 1) {
+        discard_input_line();
+        return;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(path, &w)) return;
+
+    if (process_count + w.count > MAX_PROCESSES) {
+        printf("[ERROR] File has %d processes but only %d more can be added. Use --run for large workloads.\n",
+               w.count, MAX_PROCESSES - process_count);
+        workload_free(&w);
+        return;
+    }
+
+    for (int i = 0; i < w.count; i++) {
+        Process p = w.procs[i];
+        p.pid = next_pid++;
+        p.is_completed = false;
+        simulate_memory_allocation(&p);
+        processes[process_count++] = p;
+    }
+    printf("\n[SUCCESS] %d processes loaded from '%s'.\n", w.count, path);
+    workload_free(&w);
+}
+
+static bool parse_policy(const char* name, Policy* policy) {
+    for (int i = 0; i < POLICY_COUNT; i++) {
+        const char* known = policy_name((Policy)i);
+        size_t k = 0;
+        while (known[k] != '\0' && name[k] != '\0' && (known[k] | 0x20) == (name[k] | 0x20)) k++;
+        if (known[k] == '\0' && name[k] == '\0') {
+            *policy = (Policy)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Poori string ek int honi chahiye ("3abc" ya khali string nahi chalegi).
+static bool parse_int_arg(const char* text, int* value) {
+    char* end;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0 || parsed < INT_MIN || parsed > INT_MAX) return false;
+    *value = (int)parsed;
+    return true;
+}
+
+// "--option value" jodi: argv[*i] option hai, value argv[*i + 1] se poori parse hoti hai aur *i aage
+// badhta hai. Galti par message print karke false, taaki "--max-queue five" chupchaap 0 (off) na bane.
+static bool parse_option_int(char* argv[], int* i, int* value) {
+    const char* option = argv[(*i)++];
+    if (parse_int_arg(argv[*i], value)) return true;
+    printf("[ERROR] Invalid value '%s' for %s. Must be an integer.\n", argv[*i], option);
+    return false;
+}
+
+static bool parse_option_double(char* argv[], int* i, double* value) {
+    const char* option = argv[(*i)++];
+    char* end;
+    errno = 0;
+    double parsed = strtod(argv[*i], &end);
+    if (end == argv[*i] || *end != '\0' || errno != 0 || !isfinite(parsed)) {
+        printf("[ERROR] Invalid value '%s' for %s. Must be a number.\n", argv[*i], option);
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+static bool parse_option_long_long(char* argv[], int* i, long long* value) {
+    const char* option = argv[(*i)++];
+    char* end;
+    errno = 0;
+    long long parsed = strtoll(argv[*i], &end, 10);
+    if (end == argv[*i] || *end != '\0' || errno != 0) {
+        printf("[ERROR] Invalid value '%s' for %s. Must be an integer.\n", argv[*i], option);
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+// Modes ka positional quantum: ek hi baar, positive integer. Anjaana "--" option bhi yahin pakda jaata
+// hai, taaki "--progres 5" jaisi typo chupchaap quantum na ban jaye. Galti par message print karke false.
+static bool parse_quantum_arg(const char* arg, bool* seen, int* quantum) {
+    if (arg[0] == '-' && arg[1] == '-') {
+        printf("[ERROR] Unknown option '%s'.\n", arg);
+        return false;
+    }
+    int value;
+    if (!parse_int_arg(arg, &value) || value <= 0) {
+        printf("[ERROR] Invalid time quantum '%s'. Must be a positive integer.\n", arg);
+        return false;
+    }
+    if (*seen) {
+        printf("[ERROR] Only one time quantum can be given ('%s' is extra).\n", arg);
+        return false;
+    }
+    *seen = true;
+    *quantum = value;
+    return true;
+}
+
+// Admission control ke saath run ka summary: kitne drop hue (kis wajah se) aur admit hue kaam ki latency.
+static void print_admission_report(const SimEngine* e, const AdmissionControl* ac) {
+    int n = e->n;
+    long long admitted = ac->admitted;
+    printf("\n--- RESULTS FOR: %s with admission control (%d processes) ---\n", policy_name(e->policy), n);
+    printf("| Admitted                 : %lld (%.2f%%)\n", admitted, 100.0 * admitted / n);
+    printf("| Dropped: queue full      : %lld (%.2f%%)\n", ac->dropped_queue, 100.0 * ac->dropped_queue / n);
+    printf("| Dropped: deadline        : %lld (%.2f%%)\n", ac->dropped_deadline, 100.0 * ac->dropped_deadline / n);
+    printf("| Dropped: rate limit      : %lld (%.2f%%)\n", ac->dropped_rate, 100.0 * ac->dropped_rate / n);
+    if (admitted == 0) return;
+
+    printf("| Average Waiting Time     : %.2f (admitted only)\n", (double)e->sum_waiting / admitted);
+    printf("| Average Turnaround Time  : %.2f (admitted only)\n", (double)e->sum_turnaround / admitted);
+    int* values = sim_malloc((size_t)admitted * sizeof(int), MEM_METRICS);
+    if (values != NULL) {
+        const char* names[] = { "Response", "Waiting", "Turnaround" };
+        for (int metric = 0; metric < 3; metric++) {
+            int count = 0;
+            for (int i = 0; i < n; i++) {
+                if (!e->procs[i].dropped) values[count++] = slo_metric(&e->procs[i], metric);
+            }
+            int p99 = select_kth(values, count, (int)((count * 99LL + 99) / 100) - 1);
+            printf("| P99 %-10s Time      : %d (admitted only)\n", names[metric], p99);
+        }
+        sim_free(values);
+    }
+    printf("| Makespan                 : %d\n", e->current_time);
+}
+
+// Batch mode: "--run <policy> <file> [quantum]". Bade workloads ke liye sirf averages print hote hain.
+int run_batch(int argc, char* argv[]) {
+    Policy policy;
+    if (argc < 4 || !parse_policy(argv[2], &policy)) {
+        printf("Usage: %s --run <fcfs|sjf|priority|rr> <workload file> [quantum] [--progress seconds] [--shm /name] [--columnar file]\n"
+               "       [--max-queue N] [--rate tokens/time --bucket B] [--deadline D] [--deadline-factor F]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2;
+    bool quantum_seen = false;
+    double progress_seconds = 0;
+    const char* shm_name = NULL;
+    const char* columnar_path = NULL;
+    AdmissionControl admission;
+    admission_init(&admission);
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc) {
+            if (!parse_option_double(argv, &i, &progress_seconds)) return 2;
+        } else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (strcmp(argv[i], "--columnar") == 0 && i + 1 < argc) {
+            columnar_path = argv[++i];
+        } else if (strcmp(argv[i], "--max-queue") == 0 && i + 1 < argc) {
+            if (!parse_option_int(argv, &i, &admission.max_queue)) return 2;
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            if (!parse_option_double(argv, &i, &admission.token_rate)) return 2;
+        } else if (strcmp(argv[i], "--bucket") == 0 && i + 1 < argc) {
+            if (!parse_option_double(argv, &i, &admission.token_bucket)) return 2;
+        } else if (strcmp(argv[i], "--deadline") == 0 && i + 1 < argc) {
+            if (!parse_option_int(argv, &i, &admission.deadline)) return 2;
+        } else if (strcmp(argv[i], "--deadline-factor") == 0 && i + 1 < argc) {
+            if (!parse_option_double(argv, &i, &admission.deadline_factor)) return 2;
+        } else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) {
+            return 2;
+        }
+    }
+    if (policy == POLICY_RR && time_quantum <= 0) {
+        printf("[ERROR] Invalid time quantum. Must be a positive integer.\n");
+        return 2;
+    }
+    if (progress_seconds < 0) {
+        printf("[ERROR] --progress interval cannot be negative.\n");
+        return 2;
+    }
+    if (admission.max_queue < 0 || admission.token_rate < 0 || admission.deadline < 0 || admission.deadline_factor < 0) {
+        printf("[ERROR] Admission control limits cannot be negative.\n");
+        return 2;
+    }
+    if (admission.token_rate > 0 && admission.token_bucket < 1) admission.token_bucket = 1;
+    bool admission_on = (admission.max_queue > 0 || admission.token_rate > 0 ||
+                         admission.deadline > 0 || admission.deadline_factor > 0);
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[3], &w)) return 1;
+    if (w.count == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        workload_free(&w);
+        return 1;
+    }
+
+    SimEngine engine;
+    bool small = (w.count <= MAX_PROCESSES) && !admission_on;
+    if (!engine_init(&engine, policy, time_quantum, w.procs, w.count, small)) {
+        printf("[ERROR] Failed to allocate memory for the simulation.\n");
+        workload_free(&w);
+        return 1;
+    }
+    if (admission_on) engine.admission = &admission;
+    // Columnar output engine ke hooks se stream hota hai, poore results memory mein jama kiye bina.
+    ColumnarWriter columnar;
+    if (columnar_path != NULL) {
+        if (!columnar_writer_open(&columnar, columnar_path)) {
+            engine_free(&engine);
+            workload_free(&w);
+            return 1;
+        }
+        engine.on_complete = columnar_add_result;
+        engine.on_interval = columnar_add_interval;
+        engine.hook_ctx = &columnar;
+    }
+
+    progress_enable(progress_seconds);
+    engine_run(&engine);
+    calculate_metrics(w.procs, w.count);
+    if (columnar_path != NULL) columnar_add_cpu_stats(&columnar, &engine);
+    bool columnar_ok = (columnar_path == NULL) || columnar_writer_close(&columnar);
+
+    if (small) {
+        print_results_table(w.procs, w.count, policy_name(policy));
+        print_schedstat(&engine, true);
+        print_gantt_chart(engine.gantt, engine.gantt_count);
+    } else if (admission_on) {
+        print_admission_report(&engine, &admission);
+    } else {
+        double total_wt = 0, total_tat = 0;
+        for (int i = 0; i < w.count; i++) {
+            total_wt += w.procs[i].waiting_time;
+            total_tat += w.procs[i].turnaround_time;
+        }
+        printf("\n--- RESULTS FOR: %s (%d processes) ---\n", policy_name(policy), w.count);
+        printf("| Average Waiting Time     : %.2f\n", total_wt / w.count);
+        printf("| Average Turnaround Time  : %.2f\n", total_tat / w.count);
+        printf("| Makespan                 : %d\n", engine.current_time);
+    }
+    if (!small) print_schedstat(&engine, false);
+
+    bool ok = check_schedule_invariants(&engine);
+    if (!ok) printf("[ERROR] Schedule invariant check failed.\n");
+    if (shm_name != NULL && !export_results_shm(shm_name, w.procs, w.count, policy, engine.cpu_stats, engine.cpu_count)) ok = false;
+    if (!columnar_ok) ok = false;
+    print_memory_report();
+    engine_free(&engine);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+
+// --- Packed Workload ---
+
+// Column ke liye sabse chhoti width (2 ya 4 bytes) jo max_value ko store kar sake.
+static int column_width(long long max_value) {
+    return (max_value <= UINT16_MAX) ? 2 : 4;
+}
+
+static void* column_alloc(int width, int count) {
+    return sim_malloc((size_t)width * (count > 0 ? count : 1), MEM_PROCESS_TABLE);
+}
+
+static void column_store(void* column, int width, int i, int value) {
+    if (width == 2) ((uint16_t*)column)[i] = (uint16_t)value;
+    else ((uint32_t*)column)[i] = (uint32_t)value;
+}
+
+// Column ke 'count' values int array mein widen karta hai. Har width ke liye alag simple loop,
+// taaki compiler ise vectorize kar sake.
+static void column_decode(const void* column, int width, int start, int count, int* restrict out) {
+    if (width == 2) {
+        const uint16_t* restrict c = (const uint16_t*)column + start;
+        for (int i = 0; i < count; i++) out[i] = c[i];
+    } else {
+        const uint32_t* restrict c = (const uint32_t*)column + start;
+        for (int i = 0; i < count; i++) out[i] = (int)c[i];
+    }
+}
+
+// Workload ko arrival order mein sort karke packed form mein badalta hai.
+bool pack_workload(const Workload* w, PackedWorkload* out) {
+    memset(out, 0, sizeof(*out));
+    int n = w->count;
+    int* order = sim_malloc((n > 0 ? n : 1) * sizeof(int), MEM_PROCESS_TABLE);
+    int* scratch = sim_malloc((n > 0 ? n : 1) * sizeof(int), MEM_PROCESS_TABLE);
+    if (order == NULL || scratch == NULL) {
+        sim_free(order);
+        sim_free(scratch);
+        return false;
+    }
+    sort_by_arrival(w->procs, n, order, scratch);
+    sim_free(scratch);
+
+    // Pehle ranges dekhkar har column ki width tay karna.
+    long long max_delta = 0, max_burst = 0, max_priority = 0;
+    bool identity_pids = true;
+    int previous = 0;
+    for (int i = 0; i < n; i++) {
+        const Process* p = &w->procs[order[i]];
+        if (p->arrival_time - previous > max_delta) max_delta = p->arrival_time - previous;
+        if (p->burst_time > max_burst) max_burst = p->burst_time;
+        if (p->priority > max_priority) max_priority = p->priority;
+        if (p->pid != i + 1) identity_pids = false;
+        previous = p->arrival_time;
+    }
+
+    out->count = n;
+    out->arrival_width = column_width(max_delta);
+    out->burst_width = column_width(max_burst);
+    out->priority_width = column_width(max_priority);
+    out->arrival_deltas = column_alloc(out->arrival_width, n);
+    out->bursts = column_alloc(out->burst_width, n);
+    out->priorities = column_alloc(out->priority_width, n);
+    out->checkpoints = sim_malloc((n / PACKED_CHECKPOINT_INTERVAL + 1) * sizeof(int), MEM_PROCESS_TABLE);
+    if (!identity_pids) out->pids = sim_malloc((n > 0 ? n : 1) * sizeof(int), MEM_PROCESS_TABLE);
+
+    if (out->arrival_deltas == NULL || out->bursts == NULL || out->priorities == NULL ||
+        out->checkpoints == NULL || (!identity_pids && out->pids == NULL)) {
+        sim_free(order);
+        packed_workload_free(out);
+        return false;
+    }
+
+    previous = 0;
+    for (int i = 0; i < n; i++) {
+        const Process* p = &w->procs[order[i]];
+        if (i % PACKED_CHECKPOINT_INTERVAL == 0) out->checkpoints[i / PACKED_CHECKPOINT_INTERVAL] = p->arrival_time;
+        column_store(out->arrival_deltas, out->arrival_width, i, p->arrival_time - previous);
+        column_store(out->bursts, out->burst_width, i, p->burst_time);
+        column_store(out->priorities, out->priority_width, i, p->priority);
+        if (out->pids != NULL) out->pids[i] = p->pid;
+        previous = p->arrival_time;
+    }
+    sim_free(order);
+    return true;
+}
+
+// Records [start, start + count) ko Process array mein decode karta hai (arrival order mein).
+// Checkpoint ki wajah se kisi bhi position se decode karna sasta hai.
+void unpack_workload_range(const PackedWorkload* pw, int start, int count, Process out[]) {
+    int arrivals[PACKED_DECODE_CHUNK], bursts[PACKED_DECODE_CHUNK], priorities[PACKED_DECODE_CHUNK];
+
+    // 'start' se pehle wale record ka arrival time, nearest checkpoint se shuru karke.
+    // Pehla delta khud absolute arrival hai, isliye prefix sum 0 se seedha chalta hai.
+    int arrival = 0;
+    if (start > 0) {
+        int base = (start - 1) / PACKED_CHECKPOINT_INTERVAL * PACKED_CHECKPOINT_INTERVAL;
+        arrival = pw->checkpoints[base / PACKED_CHECKPOINT_INTERVAL];
+        for (int i = base + 1; i < start; i++) {
+            column_decode(pw->arrival_deltas, pw->arrival_width, i, 1, arrivals);
+            arrival += arrivals[0];
+        }
+    }
+
+    for (int done = 0; done < count; ) {
+        int chunk = count - done;
+        if (chunk > PACKED_DECODE_CHUNK) chunk = PACKED_DECODE_CHUNK;
+        int at = start + done;
+
+        column_decode(pw->arrival_deltas, pw->arrival_width, at, chunk, arrivals);
+        column_decode(pw->bursts, pw->burst_width, at, chunk, bursts);
+        column_decode(pw->priorities, pw->priority_width, at, chunk, priorities);
+
+        // Deltas ka prefix sum.
+        for (int i = 0; i < chunk; i++) {
+            arrival += arrivals[i];
+            arrivals[i] = arrival;
+        }
+
+        for (int i = 0; i < chunk; i++) {
+            Process* p = &out[done + i];
+            memset(p, 0, sizeof(*p));
+            p->pid = (pw->pids != NULL) ? pw->pids[at + i] : at + i + 1;
+            p->arrival_time = arrivals[i];
+            p->burst_time = bursts[i];
+            p->remaining_time = bursts[i];
+            p->priority = priorities[i];
+        }
+        done += chunk;
+    }
+}
+
+// Packed workload kitni memory le raha hai (sirf data columns).
+size_t packed_workload_bytes(const PackedWorkload* pw) {
+    size_t bytes = (size_t)pw->count * (pw->arrival_width + pw->burst_width + pw->priority_width);
+    if (pw->pids != NULL) bytes += (size_t)pw->count * sizeof(int);
+    bytes += (pw->count / PACKED_CHECKPOINT_INTERVAL + 1) * sizeof(int);
+    return bytes;
+}
+
+void packed_workload_free(PackedWorkload* pw) {
+    sim_free(pw->arrival_deltas);
+    sim_free(pw->bursts);
+    sim_free(pw->priorities);
+    sim_free(pw->pids);
+    sim_free(pw->checkpoints);
+    memset(pw, 0, sizeof(*pw));
+}
+
+
+// --- Simulation Daemon ---
+// "--daemon <socket> <workload files...>" workloads ek baar load karke packed form mein rakhta hai
+// aur Unix domain socket par line-based requests serve karta hai. Har response ek JSON line hai.
+//
+//   PING
+//   LIST
+//   SIMULATE <workload> <fcfs|sjf|priority|rr> [quantum] [+arrival,burst,priority ...] [-pid ...]
+//
+// <workload> load order ka index (0 se) ya command line par diya file naam hai. '+' wale tokens
+// baseline mein naye processes jodte hain, '-' wale baseline se PIDs hatate hain. Har worker ek
+// connection serve karta hai, isliye DAEMON_IDLE_SECONDS tak chup client ka connection band hota hai.
+
+#ifndef _WIN32
+
+#define DAEMON_QUEUE_SIZE 64
+#define DAEMON_LINE_MAX 65536
+#define DAEMON_IDLE_SECONDS 30
+#define DAEMON_MAX_WORKERS 1024
+
+static PackedWorkload* daemon_workloads = NULL;
+static const char** daemon_workload_names = NULL;
+static int daemon_workload_count = 0;
+
+static int daemon_queue[DAEMON_QUEUE_SIZE];
+static int daemon_queue_head = 0, daemon_queue_count = 0;
+static pthread_mutex_t daemon_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t daemon_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t daemon_not_full = PTHREAD_COND_INITIALIZER;
+
+// Ek SIMULATE request chalakar JSON response 'reply' mein likhta hai.
+static void daemon_simulate(char* args, char* reply, size_t reply_size) {
+    char* save = NULL;
+    char* token = strtok_r(args, " \t", &save);
+    int index = -1;
+    if (token != NULL && !parse_int_arg(token, &index)) {
+        for (int i = 0; i < daemon_workload_count && index < 0; i++) {
+            if (strcmp(token, daemon_workload_names[i]) == 0) index = i;
+        }
+    }
+    if (token == NULL || index < 0 || index >= daemon_workload_count) {
+        snprintf(reply, reply_size, "{\"ok\":false,\"error\":\"unknown workload\"}");
+        return;
+    }
+
+    Policy policy;
+    token = strtok_r(NULL, " \t", &save);
+    if (token == NULL || !parse_policy(token, &policy)) {
+        snprintf(reply, reply_size, "{\"ok\":false,\"error\":\"unknown policy\"}");
+        return;
+    }
+
+    const PackedWorkload* base = &daemon_workloads[index];
+    Workload w;
+    workload_init(&w);
+    w.procs = sim_malloc((size_t)(base->count > 0 ? base->count : 1) * sizeof(Process), MEM_PROCESS_TABLE);
+    if (w.procs == NULL) {
+        snprintf(reply, reply_size, "{\"ok\":false,\"error\":\"out of memory\"}");
+        return;
+    }
+    w.capacity = (base->count > 0) ? base->count : 1;
+    unpack_workload_range(base, 0, base->count, w.procs);
+    w.count = base->count;
+
+    // Packed form arrival order mein hai; engine ke tie-break (array index) ko --run jaisa rakhne
+    // ke liye processes ko wapas file ke order (PID order) mein rakhna.
+    if (base->pids != NULL) {
+        Process* ordered = sim_malloc((size_t)w.capacity * sizeof(Process), MEM_PROCESS_TABLE);
+        if (ordered != NULL) {
+            for (int i = 0; i < w.count; i++) ordered[w.procs[i].pid - 1] = w.procs[i];
+            sim_free(w.procs);
+            w.procs = ordered;
+        }
+    }
+
+    int time_quantum = 2;
+    int next_new_pid = 0;
+    for (int i = 0; i < w.count; i++) if (w.procs[i].pid > next_new_pid) next_new_pid = w.procs[i].pid;
+    next_new_pid++;
+
+    const char* error = NULL;
+    while (error == NULL && (token = strtok_r(NULL, " \t", &save)) != NULL) {
+        if (token[0] == '+') {
+            Workload added;
+            workload_init(&added);
+            int error_line = 0;
+            if (!parse_workload_csv(token + 1, strlen(token + 1), &added, &error_line) || added.count != 1 ||
+                !workload_append(&w, added.procs[0].arrival_time, added.procs[0].burst_time, added.procs[0].priority)) {
+                error = "invalid added process";
+            } else {
+                w.procs[w.count - 1].pid = next_new_pid++;
+            }
+            workload_free(&added);
+        } else if (token[0] == '-') {
+            int pid;
+            if (!parse_int_arg(token + 1, &pid)) {
+                error = "invalid pid";
+                break;
+            }
+            int kept = 0;
+            for (int i = 0; i < w.count; i++) if (w.procs[i].pid != pid) w.procs[kept++] = w.procs[i];
+            if (kept == w.count) error = "unknown pid";
+            w.count = kept;
+        } else if (!parse_int_arg(token, &time_quantum) || time_quantum <= 0) {
+            error = "invalid quantum";
+        }
+    }
+    if (error == NULL && !workload_time_fits(&w)) error = "workload too long";
+    if (error == NULL && w.count == 0) error = "no processes";
+
+    SimEngine engine;
+    if (error == NULL && !engine_init(&engine, policy, time_quantum, w.procs, w.count, false)) error = "out of memory";
+    if (error != NULL) {
+        snprintf(reply, reply_size, "{\"ok\":false,\"error\":\"%s\"}", error);
+        workload_free(&w);
+        return;
+    }
+
+    double started = wall_seconds();
+    engine_run(&engine);
+    long long scheduled = 0, preemptions = 0, blocked = 0;
+    for (int i = 0; i < w.count; i++) {
+        scheduled += w.procs[i].schedule_count;
+        preemptions += w.procs[i].preemptions;
+        blocked += w.procs[i].blocked_time;
+    }
+    const CpuSchedStat* cpu = &engine.cpu_stats[0];
+    snprintf(reply, reply_size,
+             "{\"ok\":true,\"workload\":%d,\"policy\":\"%s\",\"quantum\":%d,\"processes\":%d,"
+             "\"avg_waiting\":%.4f,\"avg_turnaround\":%.4f,\"makespan\":%d,\"events\":%lld,"
+             "\"schedstat\":{\"scheduled\":%lld,\"preemptions\":%lld,\"blocked\":%lld,"
+             "\"cpus\":[{\"busy\":%lld,\"idle\":%lld,\"run_delay\":%lld,\"timeslices\":%lld}]},\"seconds\":%.6f}",
+             index, policy_name(policy), time_quantum, w.count,
+             (double)engine.sum_waiting / w.count, (double)engine.sum_turnaround / w.count,
+             engine.current_time, engine.events, scheduled, preemptions, blocked,
+             cpu->busy_time, cpu->idle_time, cpu->run_delay, cpu->timeslices, wall_seconds() - started);
+    engine_free(&engine);
+    workload_free(&w);
+}
+
+// Ek client connection ki saari request lines serve karta hai.
+static void daemon_serve_client(int fd) {
+    FILE* in = fdopen(fd, "r");
+    int out_fd = dup(fd);
+    FILE* out = (out_fd >= 0) ? fdopen(out_fd, "w") : NULL;
+    char* line = sim_malloc(DAEMON_LINE_MAX, MEM_IO);
+    char* reply = sim_malloc(1024, MEM_IO);
+
+    while (in != NULL && out != NULL && line != NULL && reply != NULL && fgets(line, DAEMON_LINE_MAX, in) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (strcmp(line, "PING") == 0) {
+            snprintf(reply, 1024, "{\"ok\":true}");
+        } else if (strcmp(line, "LIST") == 0) {
+            int used = snprintf(reply, 1024, "{\"ok\":true,\"workloads\":[");
+            for (int i = 0; i < daemon_workload_count && used < 1000; i++) {
+                used += snprintf(reply + used, 1024 - used, "%s%d", i > 0 ? "," : "", daemon_workloads[i].count);
+            }
+            snprintf(reply + used, 1024 - used, "]}");
+        } else if (strncmp(line, "SIMULATE ", 9) == 0) {
+            daemon_simulate(line + 9, reply, 1024);
+        } else {
+            snprintf(reply, 1024, "{\"ok\":false,\"error\":\"unknown command\"}");
+        }
+        fprintf(out, "%s\n", reply);
+        fflush(out);
+    }
+
+    sim_free(line);
+    sim_free(reply);
+    if (out != NULL) fclose(out);
+    else if (out_fd >= 0) close(out_fd);
+    if (in != NULL) fclose(in);
+    else close(fd);
+}
+
+static void* daemon_worker(void* arg) {
+    (void)arg;
+    while (true) {
+        pthread_mutex_lock(&daemon_lock);
+        while (daemon_queue_count == 0) pthread_cond_wait(&daemon_not_empty, &daemon_lock);
+        int fd = daemon_queue[daemon_queue_head];
+        daemon_queue_head = (daemon_queue_head + 1) % DAEMON_QUEUE_SIZE;
+        daemon_queue_count--;
+        pthread_cond_signal(&daemon_not_full);
+        pthread_mutex_unlock(&daemon_lock);
+
+        daemon_serve_client(fd);
+    }
+    return NULL;
+}
+
+// Daemon mode ka entry point: "--daemon <socket> <workload files...> [--workers N]".
+int run_daemon(int argc, char* argv[]) {
+    if (argc < 4) {
+        printf("Usage: %s --daemon <socket path> <workload files...> [--workers N]\n", argv[0]);
+        return 2;
+    }
+
+    int workers = 4;
+    daemon_workloads = sim_malloc((size_t)argc * sizeof(PackedWorkload), MEM_PROCESS_TABLE);
+    daemon_workload_names = sim_malloc((size_t)argc * sizeof(const char*), MEM_PROCESS_TABLE);
+    if (daemon_workloads == NULL || daemon_workload_names == NULL) return 1;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            if (!parse_option_int(argv, &i, &workers)) return 2;
+            continue;
+        }
+        Workload w;
+        workload_init(&w);
+        if (!load_workload_file(argv[i], &w)) return 1;
+        bool packed = pack_workload(&w, &daemon_workloads[daemon_workload_count]);
+        workload_free(&w);
+        if (!packed) {
+            printf("[ERROR] Failed to allocate memory for workload '%s'.\n", argv[i]);
+            return 1;
+        }
+        printf("[DAEMON] Workload %d: '%s', %d processes, %zu bytes packed.\n", daemon_workload_count, argv[i],
+               daemon_workloads[daemon_workload_count].count, packed_workload_bytes(&daemon_workloads[daemon_workload_count]));
+        daemon_workload_names[daemon_workload_count++] = argv[i];
+    }
+    if (workers <= 0 || workers > DAEMON_MAX_WORKERS) {
+        printf("[ERROR] --workers must be between 1 and %d.\n", DAEMON_MAX_WORKERS);
+        return 2;
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (server < 0 || strlen(argv[2]) >= sizeof(addr.sun_path)) {
+        printf("[ERROR] Cannot create socket '%s'.\n", argv[2]);
+        return 1;
+    }
+    strcpy(addr.sun_path, argv[2]);
+    unlink(argv[2]);
+    if (bind(server, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(server, 64) != 0) {
+        printf("[ERROR] Cannot listen on socket '%s': %s\n", argv[2], strerror(errno));
+        close(server);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); // Client beech mein chala jaye toh daemon band na ho
+
+    for (int i = 0; i < workers; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, daemon_worker, NULL) != 0) {
+            printf("[ERROR] Failed to start worker thread.\n");
+            return 1;
+        }
+        pthread_detach(thread);
+    }
+    printf("[DAEMON] Listening on '%s' with %d workers.\n", argv[2], workers);
+    fflush(stdout);
+
+    while (true) {
+        int client = accept(server, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            printf("[ERROR] accept failed: %s\n", strerror(errno));
+            break;
+        }
+        // Idle client worker ko hamesha ke liye na roke: itni der koi line na aaye toh read fail hota hai.
+        struct timeval idle = { DAEMON_IDLE_SECONDS, 0 };
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+        pthread_mutex_lock(&daemon_lock);
+        while (daemon_queue_count == DAEMON_QUEUE_SIZE) pthread_cond_wait(&daemon_not_full, &daemon_lock);
+        daemon_queue[(daemon_queue_head + daemon_queue_count) % DAEMON_QUEUE_SIZE] = client;
+        daemon_queue_count++;
+        pthread_cond_signal(&daemon_not_empty);
+        pthread_mutex_unlock(&daemon_lock);
+    }
+    close(server);
+    return 1;
+}
+
+#else
+
+int run_daemon(int argc, char* argv[]) {
+    (void)argc;
+    printf("[ERROR] %s: daemon mode needs Unix domain sockets and is not available on Windows.\n", argv[0]);
+    return 2;
+}
+
+#endif
+
+
+// --- Shared-Memory Result Export ---
+// Results ek named POSIX shared-memory segment mein likhe jaate hain (layout simulator.h mein
+// ResultSegmentHeader ke paas). Dusra process shm_open + mmap karke bina parsing ke columns padh sakta hai.
+
+#ifndef _WIN32
+
+bool export_results_shm(const char* name, const Process procs[], int n, Policy policy,
+                        const CpuSchedStat cpus[], int cpu_count) {
+    size_t column_bytes = ((size_t)n * sizeof(int32_t) + RESULT_COLUMN_ALIGN - 1) / RESULT_COLUMN_ALIGN * RESULT_COLUMN_ALIGN;
+    size_t header_bytes = (sizeof(ResultSegmentHeader) + RESULT_COLUMN_ALIGN - 1) / RESULT_COLUMN_ALIGN * RESULT_COLUMN_ALIGN;
+    size_t cpu_offset = header_bytes + column_bytes * RESULT_COLUMN_COUNT;
+    size_t total = cpu_offset + (size_t)cpu_count * sizeof(ResultCpuStat);
+
+    // Purana segment hata kar naya banao: bade purane segment ke bache bytes naye readers ko na dikhein,
+    // aur jo reader purana segment map kiye baitha hai woh apna consistent copy padhta rahe.
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)total) != 0) {
+        printf("[ERROR] Cannot create shared memory segment '%s': %s\n", name, strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    unsigned char* base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("[ERROR] Cannot map shared memory segment '%s': %s\n", name, strerror(errno));
+        return false;
+    }
+
+    ResultSegmentHeader* header = (ResultSegmentHeader*)base;
+    memset(header, 0, sizeof(*header));
+    header->version = RESULT_SEGMENT_VERSION;
+    header->column_count = RESULT_COLUMN_COUNT;
+    header->row_count = (uint64_t)n;
+    header->segment_bytes = total;
+    snprintf(header->policy, sizeof(header->policy), "%s", policy_name(policy));
+
+    int32_t* columns[RESULT_COLUMN_COUNT];
+    for (int c = 0; c < RESULT_COLUMN_COUNT; c++) {
+        header->column_offsets[c] = header_bytes + column_bytes * c;
+        columns[c] = (int32_t*)(base + header->column_offsets[c]);
+    }
+    for (int i = 0; i < n; i++) {
+        columns[RESULT_COLUMN_PID][i] = procs[i].pid;
+        columns[RESULT_COLUMN_COMPLETION][i] = procs[i].completion_time;
+        columns[RESULT_COLUMN_WAITING][i] = procs[i].waiting_time;
+        columns[RESULT_COLUMN_TURNAROUND][i] = procs[i].turnaround_time;
+        columns[RESULT_COLUMN_RESPONSE][i] = procs[i].response_time;
+        columns[RESULT_COLUMN_RUN_TIME][i] = procs[i].run_time;
+        columns[RESULT_COLUMN_RUNNABLE_TIME][i] = procs[i].runnable_time;
+        columns[RESULT_COLUMN_BLOCKED_TIME][i] = procs[i].blocked_time;
+        columns[RESULT_COLUMN_SCHEDULED][i] = procs[i].schedule_count;
+        columns[RESULT_COLUMN_PREEMPTED][i] = procs[i].preemptions;
+    }
+    header->cpu_offset = cpu_offset;
+    header->cpu_count = (uint32_t)cpu_count;
+    ResultCpuStat* cpu_rows = (ResultCpuStat*)(base + cpu_offset);
+    for (int c = 0; c < cpu_count; c++) {
+        cpu_rows[c].busy_time = cpus[c].busy_time;
+        cpu_rows[c].idle_time = cpus[c].idle_time;
+        cpu_rows[c].run_delay = cpus[c].run_delay;
+        cpu_rows[c].timeslices = cpus[c].timeslices;
+    }
+
+    // Magic sabse aakhir mein, taaki consumer adhoora segment valid na samjhe.
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(header->magic, RESULT_SEGMENT_MAGIC, sizeof(header->magic));
+    munmap(base, total);
+
+    printf("[SHM] Exported %d results to shared memory segment '%s' (%zu bytes).\n", n, name, total);
+    return true;
+}
+
+#else
+
+bool export_results_shm(const char* name, const Process procs[], int n, Policy policy,
+                        const CpuSchedStat cpus[], int cpu_count) {
+    (void)procs; (void)n; (void)policy; (void)cpus; (void)cpu_count;
+    printf("[ERROR] Shared memory export '%s' is not available on Windows.\n", name);
+    return false;
+}
+
+#endif
+
+
+// --- Columnar Results File ---
+
+static const int columnar_column_counts[COLUMNAR_TABLE_COUNT] = { RESULTS_COL_COUNT, GANTT_COL_COUNT, CPUS_COL_COUNT };
+
+static void put_le(unsigned char* b, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) b[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t get_le(const unsigned char* b, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t)b[i] << (8 * i);
+    return v;
+}
+
+static int width_for_range(uint64_t range) {
+    return (range <= 0xFF) ? 1 : (range <= 0xFFFF) ? 2 : 4;
+}
+
+static int compare_int32(const void* a, const void* b) {
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void columnar_write(ColumnarWriter* w, const void* data, size_t bytes) {
+    if (w->failed) return;
+    if (fwrite(data, 1, bytes, w->file) != bytes) w->failed = true;
+    w->offset += bytes;
+}
+
+// Ek column chunk ko sabse chhoti encoding mein likhta hai aur footer ke liye info bharta hai.
+static void columnar_write_column(ColumnarWriter* w, const int32_t* v, int n, ColumnarColumnInfo* info) {
+    int32_t min = v[0], max = v[0];
+    for (int i = 1; i < n; i++) {
+        if (v[i] < min) min = v[i];
+        if (v[i] > max) max = v[i];
+    }
+
+    // FOR: value - min
+    int for_width = width_for_range((uint64_t)((int64_t)max - min));
+    size_t best_bytes = (size_t)n * for_width;
+    ColumnarEncoding encoding = COLUMNAR_ENCODING_FOR;
+
+    // DELTA: pichhli value se farq, phir un farq ka FOR
+    int64_t delta_min = 0, delta_max = 0;
+    for (int i = 1; i < n; i++) {
+        int64_t d = (int64_t)v[i] - v[i - 1];
+        if (i == 1 || d < delta_min) delta_min = d;
+        if (i == 1 || d > delta_max) delta_max = d;
+    }
+    int delta_width = width_for_range((uint64_t)(delta_max - delta_min));
+    if (n > 1 && delta_max - delta_min <= UINT32_MAX && (size_t)(n - 1) * delta_width < best_bytes) {
+        best_bytes = (size_t)(n - 1) * delta_width;
+        encoding = COLUMNAR_ENCODING_DELTA;
+    }
+
+    // DICT: sirf tab jab <= 256 alag values hon
+    int32_t dictionary[256];
+    int dict_size = 0;
+    int32_t* sorted = sim_malloc((size_t)n * sizeof(int32_t), MEM_METRICS);
+    if (sorted != NULL) {
+        memcpy(sorted, v, (size_t)n * sizeof(int32_t));
+        qsort(sorted, n, sizeof(int32_t), compare_int32);
+        for (int i = 0; i < n && dict_size <= 256; i++) {
+            if (i == 0 || sorted[i] != sorted[i - 1]) {
+                if (dict_size < 256) dictionary[dict_size] = sorted[i];
+                dict_size++;
+            }
+        }
+        sim_free(sorted);
+        if (dict_size <= 256 && (size_t)dict_size * 4 + n < best_bytes) {
+            best_bytes = (size_t)dict_size * 4 + n;
+            encoding = COLUMNAR_ENCODING_DICT;
+        }
+    }
+
+    unsigned char* payload = sim_malloc(best_bytes > 0 ? best_bytes : 1, MEM_METRICS);
+    if (payload == NULL) {
+        w->failed = true;
+        return;
+    }
+    int width = 1;
+    int64_t base = 0, delta_base = 0;
+    if (encoding == COLUMNAR_ENCODING_FOR) {
+        width = for_width;
+        base = min;
+        for (int i = 0; i < n; i++) put_le(payload + (size_t)i * width, (uint64_t)((int64_t)v[i] - min), width);
+    } else if (encoding == COLUMNAR_ENCODING_DELTA) {
+        width = delta_width;
+        base = v[0];
+        delta_base = delta_min;
+        for (int i = 1; i < n; i++) {
+            put_le(payload + (size_t)(i - 1) * width, (uint64_t)((int64_t)v[i] - v[i - 1] - delta_min), width);
+        }
+    } else {
+        for (int i = 0; i < dict_size; i++) put_le(payload + (size_t)i * 4, (uint32_t)dictionary[i], 4);
+        for (int i = 0; i < n; i++) {
+            const int32_t* found = bsearch(&v[i], dictionary, dict_size, sizeof(int32_t), compare_int32);
+            payload[(size_t)dict_size * 4 + i] = (unsigned char)(found - dictionary);
+        }
+    }
+
+    unsigned char header[24];
+    header[0] = (unsigned char)encoding;
+    header[1] = (unsigned char)width;
+    put_le(header + 2, (encoding == COLUMNAR_ENCODING_DICT) ? dict_size : 0, 2);
+    put_le(header + 4, (uint64_t)base, 8);
+    put_le(header + 12, (uint64_t)delta_base, 8);
+    put_le(header + 20, best_bytes, 4);
+
+    info->offset = w->offset;
+    info->bytes = (uint32_t)(sizeof(header) + best_bytes);
+    info->encoding = encoding;
+    info->min = min;
+    info->max = max;
+    columnar_write(w, header, sizeof(header));
+    columnar_write(w, payload, best_bytes);
+    sim_free(payload);
+}
+
+// Table ki buffered rows ko ek chunk ki tarah file mein likhta hai.
+static void columnar_flush_table(ColumnarWriter* w, int table) {
+    int rows = w->buffered[table];
+    if (rows == 0) return;
+
+    if (w->chunk_count == w->chunk_capacity) {
+        int new_capacity = (w->chunk_capacity == 0) ? 16 : w->chunk_capacity * 2;
+        ColumnarChunkInfo* grown = sim_realloc(w->chunks, (size_t)new_capacity * sizeof(ColumnarChunkInfo), MEM_METRICS);
+        if (grown == NULL) {
+            w->failed = true;
+            return;
+        }
+        w->chunks = grown;
+        w->chunk_capacity = new_capacity;
+    }
+    ColumnarChunkInfo* chunk = &w->chunks[w->chunk_count++];
+    memset(chunk, 0, sizeof(*chunk));
+    chunk->table = (uint32_t)table;
+    chunk->rows = (uint32_t)rows;
+    chunk->column_count = (uint32_t)columnar_column_counts[table];
+    for (int c = 0; c < columnar_column_counts[table]; c++) {
+        columnar_write_column(w, w->buffers[table][c], rows, &chunk->columns[c]);
+    }
+    w->buffered[table] = 0;
+}
+
+bool columnar_writer_open(ColumnarWriter* w, const char* path) {
+    memset(w, 0, sizeof(*w));
+    w->file = fopen(path, "wb");
+    if (w->file == NULL) {
+        printf("[ERROR] Cannot create columnar file '%s'.\n", path);
+        return false;
+    }
+    for (int t = 0; t < COLUMNAR_TABLE_COUNT; t++) {
+        for (int c = 0; c < columnar_column_counts[t]; c++) {
+            w->buffers[t][c] = sim_malloc(COLUMNAR_CHUNK_ROWS * sizeof(int32_t), MEM_METRICS);
+            if (w->buffers[t][c] == NULL) w->failed = true;
+        }
+    }
+    columnar_write(w, COLUMNAR_MAGIC, 8);
+    return !w->failed;
+}
+
+// Engine ka on_complete hook: ek process ka result row buffer mein.
+void columnar_add_result(void* writer, const Process* p) {
+    ColumnarWriter* w = writer;
+    int row = w->buffered[COLUMNAR_TABLE_RESULTS];
+    int32_t** col = w->buffers[COLUMNAR_TABLE_RESULTS];
+    col[RESULTS_COL_PID][row] = p->pid;
+    col[RESULTS_COL_ARRIVAL][row] = p->arrival_time;
+    col[RESULTS_COL_BURST][row] = p->burst_time;
+    col[RESULTS_COL_PRIORITY][row] = p->priority;
+    col[RESULTS_COL_COMPLETION][row] = p->completion_time;
+    col[RESULTS_COL_WAITING][row] = p->waiting_time;
+    col[RESULTS_COL_TURNAROUND][row] = p->turnaround_time;
+    col[RESULTS_COL_RESPONSE][row] = p->response_time;
+    col[RESULTS_COL_RUN][row] = p->run_time;
+    col[RESULTS_COL_RUNNABLE][row] = p->runnable_time;
+    col[RESULTS_COL_BLOCKED][row] = p->blocked_time;
+    col[RESULTS_COL_SCHEDULED][row] = p->schedule_count;
+    col[RESULTS_COL_PREEMPTED][row] = p->preemptions;
+    if (++w->buffered[COLUMNAR_TABLE_RESULTS] == COLUMNAR_CHUNK_ROWS) columnar_flush_table(w, COLUMNAR_TABLE_RESULTS);
+}
+
+// Engine ka on_interval hook: ek CPU interval Gantt table mein.
+void columnar_add_interval(void* writer, int pid, int start, int end) {
+    ColumnarWriter* w = writer;
+    int row = w->buffered[COLUMNAR_TABLE_GANTT];
+    w->buffers[COLUMNAR_TABLE_GANTT][GANTT_COL_PID][row] = pid;
+    w->buffers[COLUMNAR_TABLE_GANTT][GANTT_COL_START][row] = start;
+    w->buffers[COLUMNAR_TABLE_GANTT][GANTT_COL_END][row] = end;
+    if (++w->buffered[COLUMNAR_TABLE_GANTT] == COLUMNAR_CHUNK_ROWS) columnar_flush_table(w, COLUMNAR_TABLE_GANTT);
+}
+
+// Run ke baad har CPU ki accounting CPUs table mein.
+void columnar_add_cpu_stats(ColumnarWriter* w, const SimEngine* e) {
+    int32_t** col = w->buffers[COLUMNAR_TABLE_CPUS];
+    for (int c = 0; c < e->cpu_count; c++) {
+        const CpuSchedStat* cpu = &e->cpu_stats[c];
+        int row = w->buffered[COLUMNAR_TABLE_CPUS];
+        col[CPUS_COL_CPU][row] = c;
+        col[CPUS_COL_BUSY][row] = (int32_t)cpu->busy_time;
+        col[CPUS_COL_IDLE][row] = (int32_t)cpu->idle_time;
+        col[CPUS_COL_RUN_DELAY_HI][row] = (int32_t)(cpu->run_delay >> 32);
+        col[CPUS_COL_RUN_DELAY_LO][row] = (int32_t)(uint32_t)cpu->run_delay;
+        col[CPUS_COL_TIMESLICES_HI][row] = (int32_t)(cpu->timeslices >> 32);
+        col[CPUS_COL_TIMESLICES_LO][row] = (int32_t)(uint32_t)cpu->timeslices;
+        if (++w->buffered[COLUMNAR_TABLE_CPUS] == COLUMNAR_CHUNK_ROWS) columnar_flush_table(w, COLUMNAR_TABLE_CPUS);
+    }
+}
+
+// Bache hue rows, footer aur trailer likhkar file band karta hai.
+bool columnar_writer_close(ColumnarWriter* w) {
+    for (int t = 0; t < COLUMNAR_TABLE_COUNT; t++) columnar_flush_table(w, t);
+
+    uint64_t footer_offset = w->offset;
+    for (int i = 0; i < w->chunk_count; i++) {
+        ColumnarChunkInfo* chunk = &w->chunks[i];
+        unsigned char entry[8 + COLUMNAR_MAX_COLUMNS * 24];
+        size_t used = 0;
+        put_le(entry, chunk->table, 4);
+        put_le(entry + 4, chunk->rows, 4);
+        used = 8;
+        for (int c = 0; c < (int)chunk->column_count; c++) {
+            ColumnarColumnInfo* info = &chunk->columns[c];
+            put_le(entry + used, info->offset, 8);
+            put_le(entry + used + 8, info->bytes, 4);
+            put_le(entry + used + 12, info->encoding, 4);
+            put_le(entry + used + 16, (uint32_t)info->min, 4);
+            put_le(entry + used + 20, (uint32_t)info->max, 4);
+            used += 24;
+        }
+        columnar_write(w, entry, used);
+    }
+    unsigned char trailer[24];
+    put_le(trailer, footer_offset, 8);
+    put_le(trailer + 8, (uint32_t)w->chunk_count, 4);
+    put_le(trailer + 12, COLUMNAR_VERSION, 4);
+    memcpy(trailer + 16, COLUMNAR_MAGIC, 8);
+    columnar_write(w, trailer, sizeof(trailer));
+
+    bool ok = !w->failed;
+    if (fclose(w->file) != 0) ok = false;
+    for (int t = 0; t < COLUMNAR_TABLE_COUNT; t++) {
+        for (int c = 0; c < COLUMNAR_MAX_COLUMNS; c++) sim_free(w->buffers[t][c]);
+    }
+    sim_free(w->chunks);
+    memset(w, 0, sizeof(*w));
+    if (!ok) printf("[ERROR] Failed to write columnar results file.\n");
+    return ok;
+}
+
+// File ka trailer aur footer padhta hai; column data zaroorat par columnar_read_column se aata hai.
+bool columnar_reader_open(ColumnarReader* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+    r->file = fopen(path, "rb");
+    if (r->file == NULL) {
+        printf("[ERROR] Cannot open columnar file '%s'.\n", path);
+        return false;
+    }
+
+    unsigned char trailer[24];
+    if (fseek(r->file, -24, SEEK_END) != 0 || fread(trailer, 1, 24, r->file) != 24 ||
+        memcmp(trailer + 16, COLUMNAR_MAGIC, 8) != 0 || get_le(trailer + 12, 4) < 1 || get_le(trailer + 12, 4) > COLUMNAR_VERSION) {
+        printf("[ERROR] '%s' is not a columnar results file.\n", path);
+        columnar_reader_close(r);
+        return false;
+    }
+    uint64_t footer_offset = get_le(trailer, 8);
+    uint32_t chunk_count = (uint32_t)get_le(trailer + 8, 4);
+    uint32_t version = (uint32_t)get_le(trailer + 12, 4);
+
+    r->chunks = sim_malloc((size_t)(chunk_count > 0 ? chunk_count : 1) * sizeof(ColumnarChunkInfo), MEM_METRICS);
+    bool ok = (r->chunks != NULL && fseek(r->file, (long)footer_offset, SEEK_SET) == 0);
+    for (uint32_t i = 0; ok && i < chunk_count; i++) {
+        unsigned char head[8], column[24];
+        ColumnarChunkInfo* chunk = &r->chunks[i];
+        memset(chunk, 0, sizeof(*chunk));
+        ok = (fread(head, 1, 8, r->file) == 8);
+        chunk->table = (uint32_t)get_le(head, 4);
+        chunk->rows = (uint32_t)get_le(head + 4, 4);
+        if (!ok || chunk->table >= COLUMNAR_TABLE_COUNT || chunk->rows > COLUMNAR_CHUNK_ROWS) ok = false;
+        if (ok && version == 1 && chunk->table == COLUMNAR_TABLE_CPUS) ok = false;
+        if (ok) {
+            chunk->column_count = (uint32_t)columnar_column_counts[chunk->table];
+            if (version == 1 && chunk->table == COLUMNAR_TABLE_RESULTS) chunk->column_count = RESULTS_COL_COUNT_V1;
+        }
+        for (int c = 0; ok && c < (int)chunk->column_count; c++) {
+            ok = (fread(column, 1, 24, r->file) == 24);
+            chunk->columns[c].offset = get_le(column, 8);
+            chunk->columns[c].bytes = (uint32_t)get_le(column + 8, 4);
+            chunk->columns[c].encoding = (uint32_t)get_le(column + 12, 4);
+            chunk->columns[c].min = (int32_t)get_le(column + 16, 4);
+            chunk->columns[c].max = (int32_t)get_le(column + 20, 4);
+        }
+        r->chunk_count = (int)i + 1;
+    }
+    if (!ok) {
+        printf("[ERROR] Corrupt footer in columnar file '%s'.\n", path);
+        columnar_reader_close(r);
+        return false;
+    }
+    return true;
+}
+
+// Ek chunk ka ek column decode karke 'out' mein likhta hai (out mein chunk->rows ki jagah honi chahiye).
+bool columnar_read_column(ColumnarReader* r, int chunk_index, int column, int32_t out[]) {
+    ColumnarChunkInfo* chunk = &r->chunks[chunk_index];
+    if (column >= (int)chunk->column_count) return false; // Purani (version 1) file mein yeh column nahi
+    ColumnarColumnInfo* info = &chunk->columns[column];
+    int n = (int)chunk->rows;
+    if (info->bytes < 24) return false;
+
+    unsigned char* data = sim_malloc(info->bytes, MEM_IO);
+    if (data == NULL) return false;
+    if (fseek(r->file, (long)info->offset, SEEK_SET) != 0 || fread(data, 1, info->bytes, r->file) != info->bytes) {
+        sim_free(data);
+        return false;
+    }
+
+    bool ok = true;
+    int encoding = data[0], width = data[1];
+    int dict_size = (int)get_le(data + 2, 2);
+    int64_t base = (int64_t)get_le(data + 4, 8);
+    int64_t delta_base = (int64_t)get_le(data + 12, 8);
+    size_t payload_bytes = get_le(data + 20, 4);
+    const unsigned char* payload = data + 24;
+    if (ok && (payload_bytes != info->bytes - 24u || (width != 1 && width != 2 && width != 4))) ok = false;
+
+    if (ok && encoding == COLUMNAR_ENCODING_FOR && payload_bytes == (size_t)n * width) {
+        for (int i = 0; i < n; i++) out[i] = (int32_t)(base + (int64_t)get_le(payload + (size_t)i * width, width));
+    } else if (ok && encoding == COLUMNAR_ENCODING_DELTA && n > 0 && payload_bytes == (size_t)(n - 1) * width) {
+        int64_t value = base;
+        out[0] = (int32_t)value;
+        for (int i = 1; i < n; i++) {
+            value += delta_base + (int64_t)get_le(payload + (size_t)(i - 1) * width, width);
+            out[i] = (int32_t)value;
+        }
+    } else if (ok && encoding == COLUMNAR_ENCODING_DICT && payload_bytes == (size_t)dict_size * 4 + n) {
+        for (int i = 0; i < n; i++) {
+            int code = payload[(size_t)dict_size * 4 + i];
+            if (code >= dict_size) { ok = false; break; }
+            out[i] = (int32_t)get_le(payload + (size_t)code * 4, 4);
+        }
+    } else {
+        ok = false;
+    }
+    sim_free(data);
+    return ok;
+}
+
+void columnar_reader_close(ColumnarReader* r) {
+    if (r->file != NULL) fclose(r->file);
+    sim_free(r->chunks);
+    memset(r, 0, sizeof(*r));
+}
+
+// "--dump-columnar": har chunk aur column ki encoding, size aur min/max print karta hai.
+int dump_columnar(const char* path) {
+    static const char* table_names[COLUMNAR_TABLE_COUNT] = { "results", "gantt", "cpus" };
+    static const char* encoding_names[] = { "FOR", "DELTA", "DICT" };
+
+    ColumnarReader r;
+    if (!columnar_reader_open(&r, path)) return 1;
+    printf("\n--- COLUMNAR FILE: %s (%d chunks) ---\n", path, r.chunk_count);
+    for (int i = 0; i < r.chunk_count; i++) {
+        ColumnarChunkInfo* chunk = &r.chunks[i];
+        printf("Chunk %d: table %s, %u rows\n", i, table_names[chunk->table], chunk->rows);
+        for (int c = 0; c < (int)chunk->column_count; c++) {
+            ColumnarColumnInfo* info = &chunk->columns[c];
+            printf("  column %d: %-5s %8u bytes, min %d, max %d\n", c,
+                   info->encoding <= COLUMNAR_ENCODING_DICT ? encoding_names[info->encoding] : "?",
+                   info->bytes, info->min, info->max);
+        }
+    }
+    columnar_reader_close(&r);
+    return 0;
+}
+
+
+// --- Schedule Diff ---
+// Do result sets ko PID par join karke har process ka farq (B - A) nikalta hai.
+// Baseline (A) ka sirf ek metric PID-indexed array mein rehta hai; B stream hota hai,
+// isliye join linear time mein hota hai aur B kabhi poora memory mein nahi aata.
+
+#define DIFF_MISSING INT_MIN
+#define DIFF_BUCKETS 33   // 0, aur har sign ke liye [2^k, 2^(k+1)) buckets
+
+typedef struct {
+    int pid;
+    long long delta;
+} DiffMover;
+
+// Bounded min-heap: sabse bade |delta| wale k movers rakhta hai.
+typedef struct {
+    DiffMover* items;
+    int count;
+    int capacity;
+} MoverHeap;
+
+typedef struct {
+    int32_t* baseline;        // baseline[pid] = A ka metric, ya DIFF_MISSING
+    int max_pid;
+    long long joined, improved, regressed, unchanged, only_in_b;
+    long long total_delta;
+    long long improved_buckets[DIFF_BUCKETS];
+    long long regressed_buckets[DIFF_BUCKETS];
+    MoverHeap top_improved;
+    MoverHeap top_regressed;
+} DiffState;
+
+static long long magnitude(long long v) {
+    return v < 0 ? -v : v;
+}
+
+static void mover_heap_offer(MoverHeap* h, int pid, long long delta) {
+    if (h->capacity == 0) return;
+    if (h->count == h->capacity) {
+        if (magnitude(delta) <= magnitude(h->items[0].delta)) return;
+        h->count--; // root hata kar naya item neeche se sift hoga
+        DiffMover last = h->items[h->count];
+        int i = 0;
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= h->count) break;
+            if (child + 1 < h->count && magnitude(h->items[child + 1].delta) < magnitude(h->items[child].delta)) child++;
+            if (magnitude(h->items[child].delta) >= magnitude(last.delta)) break;
+            h->items[i] = h->items[child];
+            i = child;
+        }
+        if (h->count > 0) h->items[i] = last;
+    }
+    int i = h->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (magnitude(h->items[parent].delta) <= magnitude(delta)) break;
+        h->items[i] = h->items[parent];
+        i = parent;
+    }
+    h->items[i].pid = pid;
+    h->items[i].delta = delta;
+}
+
+static int compare_movers(const void* a, const void* b) {
+    long long x = magnitude(((const DiffMover*)a)->delta), y = magnitude(((const DiffMover*)b)->delta);
+    if (x != y) return (x < y) ? 1 : -1;
+    return ((const DiffMover*)a)->pid - ((const DiffMover*)b)->pid;
+}
+
+static bool diff_init(DiffState* d, int max_pid, int top_k) {
+    memset(d, 0, sizeof(*d));
+    d->max_pid = max_pid;
+    d->baseline = sim_malloc(((size_t)max_pid + 1) * sizeof(int32_t), MEM_METRICS);
+    d->top_improved.items = sim_malloc((size_t)(top_k > 0 ? top_k : 1) * sizeof(DiffMover), MEM_METRICS);
+    d->top_regressed.items = sim_malloc((size_t)(top_k > 0 ? top_k : 1) * sizeof(DiffMover), MEM_METRICS);
+    d->top_improved.capacity = top_k;
+    d->top_regressed.capacity = top_k;
+    if (d->baseline == NULL || d->top_improved.items == NULL || d->top_regressed.items == NULL) return false;
+    for (int i = 0; i <= max_pid; i++) d->baseline[i] = DIFF_MISSING;
+    return true;
+}
+
+static void diff_free(DiffState* d) {
+    sim_free(d->baseline);
+    sim_free(d->top_improved.items);
+    sim_free(d->top_regressed.items);
+}
+
+static void diff_set_baseline(DiffState* d, int pid, int value) {
+    if (pid >= 0 && pid <= d->max_pid) d->baseline[pid] = value;
+}
+
+static void diff_add(DiffState* d, int pid, int value) {
+    if (pid < 0 || pid > d->max_pid || d->baseline[pid] == DIFF_MISSING) {
+        d->only_in_b++;
+        return;
+    }
+    long long delta = (long long)value - d->baseline[pid];
+    d->baseline[pid] = DIFF_MISSING; // Har PID sirf ek baar join ho
+    d->joined++;
+    d->total_delta += delta;
+    if (delta == 0) {
+        d->unchanged++;
+        return;
+    }
+    int bucket = 1;
+    while (bucket < DIFF_BUCKETS - 1 && magnitude(delta) >= (1LL << bucket)) bucket++;
+    if (delta < 0) {
+        d->improved++;
+        d->improved_buckets[bucket]++;
+        mover_heap_offer(&d->top_improved, pid, delta);
+    } else {
+        d->regressed++;
+        d->regressed_buckets[bucket]++;
+        mover_heap_offer(&d->top_regressed, pid, delta);
+    }
+}
+
+static void print_movers(MoverHeap* h, const char* title) {
+    qsort(h->items, h->count, sizeof(DiffMover), compare_movers);
+    printf("| %s:\n", title);
+    for (int i = 0; i < h->count; i++) printf("|   P%-8d %+lld\n", h->items[i].pid, h->items[i].delta);
+    if (h->count == 0) printf("|   (none)\n");
+}
+
+static void diff_report(DiffState* d, const char* metric, const char* a_name, const char* b_name) {
+    long long only_in_a = 0;
+    for (int i = 0; i <= d->max_pid; i++) if (d->baseline[i] != DIFF_MISSING) only_in_a++;
+
+    printf("\n--- SCHEDULE DIFF: %s (%s -> %s) ---\n", metric, a_name, b_name);
+    printf("| Joined processes : %lld (only in A: %lld, only in B: %lld)\n", d->joined, only_in_a, d->only_in_b);
+    printf("| Improved         : %lld\n", d->improved);
+    printf("| Regressed        : %lld\n", d->regressed);
+    printf("| Unchanged        : %lld\n", d->unchanged);
+    if (d->joined > 0) printf("| Average delta    : %+.2f\n", (double)d->total_delta / d->joined);
+
+    printf("| Distribution of |delta|:\n");
+    for (int b = 1; b < DIFF_BUCKETS; b++) {
+        if (d->improved_buckets[b] == 0 && d->regressed_buckets[b] == 0) continue;
+        long long lo = 1LL << (b - 1), hi = (b < DIFF_BUCKETS - 1) ? (1LL << b) - 1 : LLONG_MAX;
+        printf("|   %10lld - %-10lld improved %-10lld regressed %lld\n", lo, hi, d->improved_buckets[b], d->regressed_buckets[b]);
+    }
+    print_movers(&d->top_improved, "Top improvements");
+    print_movers(&d->top_regressed, "Top regressions");
+}
+
+static int diff_metric_column(const char* name) {
+    if (strcmp(name, "waiting") == 0) return RESULTS_COL_WAITING;
+    if (strcmp(name, "turnaround") == 0) return RESULTS_COL_TURNAROUND;
+    if (strcmp(name, "response") == 0) return RESULTS_COL_RESPONSE;
+    if (strcmp(name, "completion") == 0) return RESULTS_COL_COMPLETION;
+    if (strcmp(name, "scheduled") == 0) return RESULTS_COL_SCHEDULED;
+    if (strcmp(name, "preempted") == 0) return RESULTS_COL_PREEMPTED;
+    return -1;
+}
+
+static const char* diff_metric_name(int column) {
+    switch (column) {
+        case RESULTS_COL_TURNAROUND: return "turnaround";
+        case RESULTS_COL_RESPONSE: return "response";
+        case RESULTS_COL_COMPLETION: return "completion";
+        case RESULTS_COL_SCHEDULED: return "scheduled";
+        case RESULTS_COL_PREEMPTED: return "preempted";
+        default: return "waiting";
+    }
+}
+
+static int process_metric(const Process* p, int column) {
+    switch (column) {
+        case RESULTS_COL_TURNAROUND: return p->turnaround_time;
+        case RESULTS_COL_RESPONSE: return p->response_time;
+        case RESULTS_COL_COMPLETION: return p->completion_time;
+        case RESULTS_COL_SCHEDULED: return p->schedule_count;
+        case RESULTS_COL_PREEMPTED: return p->preemptions;
+        default: return p->waiting_time;
+    }
+}
+
+// Columnar file ke results chunks ek-ek karke padhkar baseline bharta (ya diff karta) hai.
+static bool diff_stream_columnar(ColumnarReader* r, int column, DiffState* d, bool baseline) {
+    int32_t* pids = sim_malloc(COLUMNAR_CHUNK_ROWS * sizeof(int32_t), MEM_METRICS);
+    int32_t* values = sim_malloc(COLUMNAR_CHUNK_ROWS * sizeof(int32_t), MEM_METRICS);
+    bool ok = (pids != NULL && values != NULL);
+    for (int c = 0; ok && c < r->chunk_count; c++) {
+        if (r->chunks[c].table != COLUMNAR_TABLE_RESULTS) continue;
+        ok = columnar_read_column(r, c, RESULTS_COL_PID, pids) && columnar_read_column(r, c, column, values);
+        for (uint32_t i = 0; ok && i < r->chunks[c].rows; i++) {
+            if (baseline) diff_set_baseline(d, pids[i], values[i]);
+            else diff_add(d, pids[i], values[i]);
+        }
+    }
+    sim_free(pids);
+    sim_free(values);
+    return ok;
+}
+
+static int columnar_max_pid(const ColumnarReader* r) {
+    int max_pid = 0;
+    for (int c = 0; c < r->chunk_count; c++) {
+        if (r->chunks[c].table == COLUMNAR_TABLE_RESULTS && r->chunks[c].columns[RESULTS_COL_PID].max > max_pid) {
+            max_pid = r->chunks[c].columns[RESULTS_COL_PID].max;
+        }
+    }
+    return max_pid;
+}
+
+// Diff options: "--metric <waiting|turnaround|response|completion|scheduled|preempted>" aur "--top <k>".
+static bool parse_diff_options(int argc, char* argv[], int first, int* column, int* top_k, int* quantum) {
+    *column = RESULTS_COL_WAITING;
+    *top_k = 10;
+    bool quantum_seen = false;
+    for (int i = first; i < argc; i++) {
+        if (strcmp(argv[i], "--metric") == 0 && i + 1 < argc) {
+            *column = diff_metric_column(argv[++i]);
+            if (*column < 0) return false;
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            if (!parse_int_arg(argv[++i], top_k) || *top_k < 0) return false;
+        } else if (quantum != NULL) {
+            if (!parse_quantum_arg(argv[i], &quantum_seen, quantum)) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// "--diff a.pcol b.pcol": do runs ki columnar files ka diff.
+int run_diff(int argc, char* argv[]) {
+    int column, top_k;
+    if (argc < 4 || !parse_diff_options(argc, argv, 4, &column, &top_k, NULL)) {
+        printf("Usage: %s --diff <a.pcol> <b.pcol> [--metric waiting|turnaround|response|completion|scheduled|preempted] [--top k]\n", argv[0]);
+        return 2;
+    }
+
+    ColumnarReader a, b;
+    if (!columnar_reader_open(&a, argv[2])) return 1;
+    if (!columnar_reader_open(&b, argv[3])) {
+        columnar_reader_close(&a);
+        return 1;
+    }
+
+    DiffState d;
+    bool ok = diff_init(&d, columnar_max_pid(&a), top_k) &&
+              diff_stream_columnar(&a, column, &d, true) &&
+              diff_stream_columnar(&b, column, &d, false);
+    if (ok) diff_report(&d, diff_metric_name(column), argv[2], argv[3]);
+    else printf("[ERROR] Failed to read columnar results.\n");
+
+    diff_free(&d);
+    columnar_reader_close(&a);
+    columnar_reader_close(&b);
+    return ok ? 0 : 1;
+}
+
+typedef struct {
+    DiffState* diff;
+    int column;
+    bool baseline;
+} DiffHookContext;
+
+static void diff_on_complete(void* ctx, const Process* p) {
+    DiffHookContext* h = ctx;
+    if (h->baseline) diff_set_baseline(h->diff, p->pid, process_metric(p, h->column));
+    else diff_add(h->diff, p->pid, process_metric(p, h->column));
+}
+
+// "--diff-policies <workload> <A> <B> [quantum]": ek hi workload par do policies ka diff.
+// Dono runs on_complete hook se stream hote hain, koi intermediate file nahi banti.
+int run_policy_diff(int argc, char* argv[]) {
+    Policy policies[2];
+    int column, top_k, time_quantum = 2;
+    if (argc < 5 || !parse_policy(argv[3], &policies[0]) || !parse_policy(argv[4], &policies[1]) ||
+        !parse_diff_options(argc, argv, 5, &column, &top_k, &time_quantum)) {
+        printf("Usage: %s --diff-policies <workload file> <policy A> <policy B> [quantum] [--metric m] [--top k]\n", argv[0]);
+        return 2;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[2], &w)) return 1;
+
+    DiffState d;
+    bool ok = diff_init(&d, w.count, top_k);
+    for (int run = 0; ok && run < 2; run++) {
+        SimEngine engine;
+        DiffHookContext hook = { &d, column, run == 0 };
+        ok = engine_init(&engine, policies[run], time_quantum, w.procs, w.count, false);
+        if (!ok) break;
+        engine.on_complete = diff_on_complete;
+        engine.hook_ctx = &hook;
+        engine_run(&engine);
+        engine_free(&engine);
+    }
+    if (ok) diff_report(&d, diff_metric_name(column), policy_name(policies[0]), policy_name(policies[1]));
+    else printf("[ERROR] Failed to allocate memory for the diff.\n");
+
+    diff_free(&d);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+
+// --- Sampling Mode ---
+// Poore trace ki jagah random time windows simulate karke average metrics ka estimate deta hai.
+// Window ke processes jis busy period mein hain, simulation uske shuru se chalti hai (warm-up) aur
+// window ke aakhri process ke busy period ke end tak (cool-down). Saari policies work-conserving hain,
+// isliye busy periods policy par nirbhar nahi; CPU khali hone par pichhla history asar nahi karta,
+// aur window ke processes original index order mein engine ko milte hain (same key par tie-break index se
+// hota hai), toh har window ka result poore run jaisa exact hai aur overload mein aaya backlog bhi dikhta hai.
+// Sirf window ke andar aaye processes measure hote hain. Windows random order mein batches mein
+// chalti hain; har batch ke baad 95% confidence interval chhota hota jaata hai.
+
+#define SAMPLE_CONTEXT_WARN 8   // Har measured process par isse zyada simulate hue toh warning
+
+typedef struct {
+    long long count;          // Window mein measure hue processes
+    long long sum_waiting;
+    long long sum_turnaround;
+    long long simulated;      // Warm-up aur cool-down mila kar kitne processes chale
+} WindowSample;
+
+// Arrival order mein har process ke busy period ki seema: period_first[k] us period ka pehla index,
+// period_last[k] aakhri index + 1.
+static void sample_busy_periods(const Process procs[], const int order[], int n, int period_first[], int period_last[]) {
+    long long busy_until = LLONG_MIN;
+    int first = 0;
+    for (int k = 0; k < n; k++) {
+        const Process* p = &procs[order[k]];
+        if (p->arrival_time >= busy_until) {
+            first = k;
+            busy_until = p->arrival_time;
+        }
+        busy_until += p->burst_time;
+        period_first[k] = first;
+    }
+    for (int k = n - 1; k >= 0; k--) {
+        period_last[k] = (k == n - 1 || period_first[k + 1] != period_first[k]) ? k + 1 : period_last[k + 1];
+    }
+}
+
+// Sorted arrival order mein pehla index jiska arrival >= time.
+static int lower_bound_arrival(const Process procs[], const int order[], int n, long long time) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (procs[order[mid]].arrival_time < time) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static int compare_process_index(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Ek window [start, start + length) ko uske busy periods ke saath simulate karta hai.
+static bool simulate_window(const Workload* w, const int order[], const int period_first[], const int period_last[],
+                            Policy policy, int time_quantum, long long start, long long length, WindowSample* out) {
+    int measured_first = lower_bound_arrival(w->procs, order, w->count, start);
+    int measured_last = lower_bound_arrival(w->procs, order, w->count, start + length);
+    memset(out, 0, sizeof(*out));
+    if (measured_first == measured_last) return true;
+    int first = period_first[measured_first];
+    int last = period_last[measured_last - 1];
+    int n = last - first;
+    out->simulated = n;
+
+    // Slice ko wapas original index order mein: engine same key par chhote index ko pehle chalata hai,
+    // aur unsorted traces par arrival order wala copy woh tie-break badal deta.
+    Process* procs = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+    int* indices = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+    if (procs == NULL || indices == NULL) {
+        sim_free(procs);
+        sim_free(indices);
+        return false;
+    }
+    memcpy(indices, order + first, (size_t)n * sizeof(int));
+    qsort(indices, n, sizeof(int), compare_process_index);
+    for (int i = 0; i < n; i++) procs[i] = w->procs[indices[i]];
+    sim_free(indices);
+
+    SimEngine engine;
+    if (!engine_init(&engine, policy, time_quantum, procs, n, false)) {
+        sim_free(procs);
+        return false;
+    }
+    engine_run(&engine);
+    for (int i = 0; i < n; i++) {
+        if (procs[i].arrival_time >= start && procs[i].arrival_time < start + length) {
+            out->count++;
+            out->sum_waiting += procs[i].waiting_time;
+            out->sum_turnaround += procs[i].turnaround_time;
+        }
+    }
+    engine_free(&engine);
+    sim_free(procs);
+    return true;
+}
+
+// Ratio estimator (sum y / sum x) aur uska 95% half-width, windows ko clusters maan kar.
+static void ratio_estimate(const WindowSample samples[], int sampled, int total_windows, bool turnaround,
+                           double* estimate, double* half_width) {
+    double sum_y = 0, sum_x = 0;
+    for (int i = 0; i < sampled; i++) {
+        sum_y += turnaround ? samples[i].sum_turnaround : samples[i].sum_waiting;
+        sum_x += samples[i].count;
+    }
+    *estimate = (sum_x > 0) ? sum_y / sum_x : 0;
+    *half_width = 0;
+    if (sampled < 2 || sum_x == 0) return;
+
+    double ss = 0;
+    for (int i = 0; i < sampled; i++) {
+        double y = turnaround ? samples[i].sum_turnaround : samples[i].sum_waiting;
+        double r = y - *estimate * samples[i].count;
+        ss += r * r;
+    }
+    double mean_x = sum_x / sampled;
+    double fpc = 1.0 - (double)sampled / total_windows; // Finite population correction
+    double variance = fpc * (ss / (sampled - 1)) / (sampled * mean_x * mean_x);
+    *half_width = 1.96 * sqrt(variance > 0 ? variance : 0);
+}
+
+// Random workloads (kabhi underload, kabhi overload) par saari windows sample karke dekhta hai ki
+// unka jod poore run ke barabar hai. Pehla mismatch print karke false.
+bool validate_sampling(long runs, uint64_t seed) {
+    printf("\n--- VALIDATING SAMPLING (%ld random workloads, every window sampled) ---\n", runs);
+    for (long run = 0; run < runs; run++) {
+        uint64_t rng = seed ^ ((uint64_t)run * 0x9E3779B97F4A7C15ULL);
+        int n = 1 + (int)(sim_random(&rng) % 300);
+        int gap = 1 + (int)(sim_random(&rng) % 12);       // Mean burst 4.5: gap chhota matlab overload
+        int total_windows = 1 + (int)(sim_random(&rng) % 40);
+        Policy policy = (Policy)(sim_random(&rng) % POLICY_COUNT);
+        int time_quantum = 1 + (int)(sim_random(&rng) % 4);
+
+        Workload w;
+        workload_init(&w);
+        int* order = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+        int* period_first = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+        int* period_last = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+        WindowSample* samples = sim_malloc((size_t)total_windows * sizeof(WindowSample), MEM_METRICS);
+        bool ok = (order != NULL && period_first != NULL && period_last != NULL && samples != NULL);
+        int arrival = 0;
+        for (int i = 0; ok && i < n; i++) {
+            arrival += (int)(sim_random(&rng) % (uint64_t)gap);
+            ok = workload_append(&w, arrival, 1 + (int)(sim_random(&rng) % 8), (int)(sim_random(&rng) % 4));
+        }
+        // Arrivals ko PIDs mein bikhera jaata hai, taaki unsorted traces ka index tie-break bhi test ho.
+        for (int i = n - 1; ok && i > 0; i--) {
+            int j = (int)(sim_random(&rng) % (uint64_t)(i + 1));
+            int t = w.procs[i].arrival_time; w.procs[i].arrival_time = w.procs[j].arrival_time; w.procs[j].arrival_time = t;
+        }
+
+        long long window_waiting = 0, window_turnaround = 0, window_count = 0;
+        SimEngine engine;
+        if (ok) {
+            sort_by_arrival(w.procs, n, order, period_first);
+            sample_busy_periods(w.procs, order, n, period_first, period_last);
+            long long span = (long long)w.procs[order[n - 1]].arrival_time - w.procs[order[0]].arrival_time + 1;
+            long long length = (span + total_windows - 1) / total_windows;
+            for (long long start = w.procs[order[0]].arrival_time; ok && start <= w.procs[order[n - 1]].arrival_time; start += length) {
+                WindowSample sample;
+                ok = simulate_window(&w, order, period_first, period_last, policy, time_quantum, start, length, &sample);
+                window_waiting += sample.sum_waiting;
+                window_turnaround += sample.sum_turnaround;
+                window_count += sample.count;
+            }
+        }
+        ok = ok && engine_init(&engine, policy, time_quantum, w.procs, n, false);
+        if (ok) {
+            engine_run(&engine);
+            if (window_count != n || window_waiting != engine.sum_waiting || window_turnaround != engine.sum_turnaround) {
+                printf("[MISMATCH] Run %ld, policy %s, %d processes, %d windows: windows gave %lld/%lld waiting/turnaround,"
+                       " full run %lld/%lld.\n", run, policy_name(policy), n, total_windows, window_waiting,
+                       window_turnaround, engine.sum_waiting, engine.sum_turnaround);
+                ok = false;
+            }
+            engine_free(&engine);
+        } else {
+            printf("[ERROR] Failed to allocate memory for sampling validation run %ld.\n", run);
+        }
+        sim_free(order);
+        sim_free(period_first);
+        sim_free(period_last);
+        sim_free(samples);
+        workload_free(&w);
+        if (!ok) return false;
+    }
+    printf("[SUCCESS] Sampling every window reproduced the full run on all %ld workloads.\n", runs);
+    return true;
+}
+
+// "--sample <policy> <workload> [quantum] [--windows N] [--target-error pct] [--seed s]"
+int run_sample(int argc, char* argv[]) {
+    Policy policy;
+    if (argc < 4 || !parse_policy(argv[2], &policy)) {
+        printf("Usage: %s --sample <fcfs|sjf|priority|rr> <workload file> [quantum] [--windows N] [--target-error pct] [--seed s]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2;
+    bool quantum_seen = false;
+    int total_windows = 1000;
+    double target_error = 2.0;
+    uint64_t seed = 12345;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--windows") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &total_windows)) return 2; }
+        else if (strcmp(argv[i], "--target-error") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &target_error)) return 2; }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) return 2;
+    }
+    if (time_quantum <= 0 || total_windows <= 0) {
+        printf("[ERROR] Quantum and window count must be positive integers.\n");
+        return 2;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[3], &w)) return 1;
+    if (w.count == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        workload_free(&w);
+        return 1;
+    }
+
+    int* order = sim_malloc((size_t)w.count * sizeof(int), MEM_PROCESS_TABLE);
+    int* scratch = sim_malloc((size_t)w.count * sizeof(int), MEM_PROCESS_TABLE);
+    int* period_last = sim_malloc((size_t)w.count * sizeof(int), MEM_PROCESS_TABLE);
+    int* window_order = sim_malloc((size_t)total_windows * sizeof(int), MEM_METRICS);
+    WindowSample* samples = sim_malloc((size_t)total_windows * sizeof(WindowSample), MEM_METRICS);
+    if (order == NULL || scratch == NULL || period_last == NULL || window_order == NULL || samples == NULL) {
+        printf("[ERROR] Failed to allocate memory for sampling.\n");
+        sim_free(order); sim_free(scratch); sim_free(period_last); sim_free(window_order); sim_free(samples);
+        workload_free(&w);
+        return 1;
+    }
+    sort_by_arrival(w.procs, w.count, order, scratch);
+    int* period_first = scratch; // Sort ke baad scratch busy periods ke kaam aata hai
+    sample_busy_periods(w.procs, order, w.count, period_first, period_last);
+
+    long long first_arrival = w.procs[order[0]].arrival_time;
+    long long span = (long long)w.procs[order[w.count - 1]].arrival_time - first_arrival + 1;
+    long long length = (span + total_windows - 1) / total_windows;
+    total_windows = (int)((span + length - 1) / length);
+
+    // Windows ka random order (Fisher-Yates), taaki har prefix ek random sample ho.
+    for (int i = 0; i < total_windows; i++) window_order[i] = i;
+    for (int i = total_windows - 1; i > 0; i--) {
+        int j = (int)(sim_random(&seed) % (uint64_t)(i + 1));
+        int t = window_order[i]; window_order[i] = window_order[j]; window_order[j] = t;
+    }
+
+    printf("\n--- SAMPLING: %s on %d processes, %d windows of %lld time units ---\n",
+           policy_name(policy), w.count, total_windows, length);
+    printf("+---------+------------+------------------------+------------------------+\n");
+    printf("| Windows | Processes  | Avg Waiting (95%% CI)   | Avg Turnaround (95%% CI)|\n");
+    printf("+---------+------------+------------------------+------------------------+\n");
+
+    double started = wall_seconds();
+    int sampled = 0;
+    int batch = 8;
+    bool ok = true;
+    while (ok && sampled < total_windows) {
+        int end = (sampled + batch < total_windows) ? sampled + batch : total_windows;
+        int failures = 0;
+
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:failures)
+        for (int i = sampled; i < end; i++) {
+            long long start = first_arrival + (long long)window_order[i] * length;
+            if (!simulate_window(&w, order, period_first, period_last, policy, time_quantum, start, length, &samples[i])) failures++;
+        }
+        ok = (failures == 0);
+        sampled = end;
+        batch *= 2;
+
+        double wt, wt_hw, tat, tat_hw;
+        ratio_estimate(samples, sampled, total_windows, false, &wt, &wt_hw);
+        ratio_estimate(samples, sampled, total_windows, true, &tat, &tat_hw);
+        long long measured = 0;
+        for (int i = 0; i < sampled; i++) measured += samples[i].count;
+        printf("| %-7d | %-10lld | %10.2f +- %-9.2f | %10.2f +- %-9.2f |\n", sampled, measured, wt, wt_hw, tat, tat_hw);
+        fflush(stdout);
+
+        // Dono metrics target relative error ke andar aa gaye toh ruk jao.
+        if (sampled >= 10 && wt_hw <= wt * target_error / 100 && tat_hw <= tat * target_error / 100) break;
+    }
+    printf("+---------+------------+------------------------+------------------------+\n");
+    if (!ok) printf("[ERROR] Failed to allocate memory for a sample window.\n");
+    printf("| Sampled %d of %d windows in %.3f seconds (target relative error %.1f%%).\n",
+           sampled, total_windows, wall_seconds() - started, target_error);
+    long long measured = 0, simulated = 0;
+    for (int i = 0; i < sampled; i++) {
+        measured += samples[i].count;
+        simulated += samples[i].simulated;
+    }
+    if (measured > 0 && simulated > SAMPLE_CONTEXT_WARN * measured) {
+        printf("[WARN] Backlog carries across windows (overload): %.1f processes simulated per measured process.\n"
+               "       Estimates stay exact per window, but a full --run may be cheaper.\n", (double)simulated / measured);
+    }
+
+    sim_free(order);
+    sim_free(period_first);
+    sim_free(period_last);
+    sim_free(window_order);
+    sim_free(samples);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+
+// --- Race Mode (Branch and Bound) ---
+// Saari policies simulated time mein saath-saath (lock-step) chalti hain. Har checkpoint par har
+// policy ke final total waiting time ka ek lower bound aur ek upper bound nikalta hai:
+//  - Lower bound: ab tak ka waiting + abhi maujood processes ka minimum aage ka waiting
+//    (remaining times ko SPT order mein chalane par), kyunki naye arrivals sirf waiting badhate hain.
+//  - Upper bound: poore hue processes ka asli waiting + baaki har process ke liye uske busy period
+//    ke end tak ka waiting. Saari policies work-conserving hain, isliye busy periods sab ke liye same
+//    hain aur koi process apne busy period ke baad poora nahi ho sakta.
+// Jis policy ka lower bound kisi doosri policy ke upper bound se zyada ho, woh jeet nahi sakti aur
+// wahin chhod di jaati hai. Bachi hui policies poori chalti hain aur unke exact metrics report hote hain.
+
+#define RACE_CHECKPOINTS 64
+
+typedef struct {
+    SimEngine engine;
+    Process* procs;
+    long long upper_slack;    // Sum of (busy period end - arrival - burst - waiting) of unfinished processes
+    const long long* slack;   // Har process ka (busy period end - arrival - burst)
+    long long completed_arrival_sum;
+    long long completed_burst_sum;
+    bool alive;
+    int pruned_at;
+    long long pruned_bound;
+} RaceEntry;
+
+// Race ka shared, read-only data: arrival order aur uske prefix sums.
+typedef struct {
+    const Process* workload;
+    const int* order;
+    const long long* arrival_prefix;  // arrival_prefix[k] = pehle k arrivals ka jod
+    int n;
+} RaceWorkload;
+
+static void race_on_complete(void* ctx, const Process* p) {
+    RaceEntry* r = ctx;
+    long long index = p - r->procs;
+    r->upper_slack -= r->slack[index] - p->waiting_time;
+    r->completed_arrival_sum += p->arrival_time;
+    r->completed_burst_sum += p->burst_time;
+}
+
+// Final total waiting time ka lower bound (time e->current_time par).
+// Ab tak ka waiting prefix sums se O(log n) mein; SPT term sirf maujood processes par.
+static long long race_lower_bound(const RaceEntry* r, const RaceWorkload* rw, long long* scratch) {
+    const SimEngine* e = &r->engine;
+    long long t = e->current_time;
+
+    // Kitne processes t tak aa chuke hain (binary search arrival order par).
+    int lo = 0, hi = rw->n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (rw->workload[rw->order[mid]].arrival_time <= t) lo = mid + 1;
+        else hi = mid;
+    }
+    int arrived = lo;
+    long long present_count = arrived - e->completed;
+    long long present_arrival_sum = rw->arrival_prefix[arrived] - r->completed_arrival_sum;
+    long long present_executed = e->busy_time - r->completed_burst_sum;
+    long long accrued = e->sum_waiting + present_count * t - present_arrival_sum - present_executed;
+
+    // Maujood processes: running, ready structure, aur jo aa chuke par abhi admit nahi hue.
+    int present = 0;
+    if (e->running != -1) scratch[present++] = e->procs[e->running].remaining_time;
+    for (int i = 0; i < e->ready_count; i++) scratch[present++] = e->procs[ready_item(e, i)].remaining_time;
+    for (int i = e->next_arrival; i < arrived; i++) scratch[present++] = e->procs[e->order[i]].remaining_time;
+
+    // SPT: sabse chhota remaining pehle; i-th job ke remaining time tak baaki (present - 1 - i) jobs rukenge.
+    qsort(scratch, present, sizeof(long long), compare_long_long);
+    for (int i = 0; i < present; i++) accrued += scratch[i] * (present - 1 - i);
+    return accrued;
+}
+
+// Simulation ko kam se kam 'horizon' time tak aage badhata hai (ya poora hone tak).
+void engine_advance(SimEngine* e, long long horizon) {
+    while (e->completed + e->dropped < e->n && e->current_time < horizon) engine_step(e);
+}
+
+// Diye gaye processes par saari policies ki race chalakar average waiting time ka winner batata hai.
+bool race_policies(const Process workload[], int n, int time_quantum) {
+    RaceEntry entries[POLICY_COUNT];
+    long long* slack = sim_malloc((size_t)n * sizeof(long long), MEM_METRICS);
+    long long* scratch = sim_malloc((size_t)n * sizeof(long long), MEM_METRICS);
+    int* order = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+    int* sort_scratch = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+    long long* arrival_prefix = sim_malloc(((size_t)n + 1) * sizeof(long long), MEM_METRICS);
+    bool ok = (slack != NULL && scratch != NULL && order != NULL && sort_scratch != NULL && arrival_prefix != NULL);
+    RaceWorkload rw = { workload, order, arrival_prefix, n };
+
+    // Busy periods: arrival order mein CPU kab tak lagataar busy rahega.
+    long long makespan = 0, total_slack = 0;
+    if (ok) {
+        sort_by_arrival(workload, n, order, sort_scratch);
+        int period_start = 0;
+        long long busy_until = 0;
+        for (int k = 0; k <= n; k++) {
+            if (k == n || workload[order[k]].arrival_time >= busy_until) {
+                for (int j = period_start; j < k; j++) {
+                    const Process* p = &workload[order[j]];
+                    slack[order[j]] = busy_until - p->arrival_time - p->burst_time;
+                    total_slack += slack[order[j]];
+                }
+                period_start = k;
+                if (k == n) break;
+                busy_until = workload[order[k]].arrival_time;
+            }
+            busy_until += workload[order[k]].burst_time;
+        }
+        makespan = busy_until;
+
+        arrival_prefix[0] = 0;
+        for (int k = 0; k < n; k++) arrival_prefix[k + 1] = arrival_prefix[k] + workload[order[k]].arrival_time;
+    }
+
+    for (int i = 0; i < POLICY_COUNT; i++) entries[i].procs = NULL;
+    for (int i = 0; ok && i < POLICY_COUNT; i++) {
+        RaceEntry* r = &entries[i];
+        r->procs = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+        if (r->procs == NULL) { ok = false; break; }
+        memcpy(r->procs, workload, (size_t)n * sizeof(Process));
+        if (!engine_init(&r->engine, (Policy)i, time_quantum, r->procs, n, false)) {
+            sim_free(r->procs);
+            r->procs = NULL;
+            ok = false;
+            break;
+        }
+        r->engine.on_complete = race_on_complete;
+        r->engine.hook_ctx = r;
+        r->slack = slack;
+        r->upper_slack = total_slack;
+        r->completed_arrival_sum = 0;
+        r->completed_burst_sum = 0;
+        r->alive = true;
+        r->pruned_at = -1;
+    }
+
+    if (ok) {
+        printf("\n--- RACE: %d processes, makespan %lld, %d checkpoints ---\n", n, makespan, RACE_CHECKPOINTS);
+        for (int c = 1; c <= RACE_CHECKPOINTS; c++) {
+            long long horizon = makespan * c / RACE_CHECKPOINTS;
+            long long lower[POLICY_COUNT], best_upper = LLONG_MAX;
+            for (int i = 0; i < POLICY_COUNT; i++) {
+                if (!entries[i].alive) continue;
+                engine_advance(&entries[i].engine, horizon);
+                lower[i] = race_lower_bound(&entries[i], &rw, scratch);
+                long long upper = entries[i].engine.sum_waiting + entries[i].upper_slack;
+                if (upper < best_upper) best_upper = upper;
+            }
+            for (int i = 0; i < POLICY_COUNT; i++) {
+                if (entries[i].alive && lower[i] > best_upper) {
+                    entries[i].alive = false;
+                    entries[i].pruned_at = entries[i].engine.current_time;
+                    entries[i].pruned_bound = lower[i];
+                    printf("[RACE] %-8s pruned at time %d: total waiting >= %lld, but another policy guarantees <= %lld\n",
+                           policy_name((Policy)i), entries[i].pruned_at, lower[i], best_upper);
+                }
+            }
+        }
+
+        int winner = -1;
+        printf("+----------+------------------+---------------------+\n");
+        printf("| Policy   | Avg Waiting Time | Avg Turnaround Time |\n");
+        printf("+----------+------------------+---------------------+\n");
+        for (int i = 0; i < POLICY_COUNT; i++) {
+            SimEngine* e = &entries[i].engine;
+            if (!entries[i].alive) {
+                printf("| %-8s | >= %-13.2f | (pruned)            |\n", policy_name((Policy)i), (double)entries[i].pruned_bound / n);
+                continue;
+            }
+            engine_run(e);
+            printf("| %-8s | %-16.2f | %-19.2f |\n", policy_name((Policy)i), (double)e->sum_waiting / n, (double)e->sum_turnaround / n);
+            if (winner == -1 || e->sum_waiting < entries[winner].engine.sum_waiting) winner = i;
+        }
+        printf("+----------+------------------+---------------------+\n");
+        printf("[ANALYSIS] Best average waiting time: %s (%.2f).\n", policy_name((Policy)winner),
+               (double)entries[winner].engine.sum_waiting / n);
+    } else {
+        printf("[ERROR] Failed to allocate memory for the race.\n");
+    }
+
+    for (int i = 0; i < POLICY_COUNT; i++) {
+        if (entries[i].procs == NULL) continue;
+        engine_free(&entries[i].engine);
+        sim_free(entries[i].procs);
+    }
+    sim_free(slack);
+    sim_free(scratch);
+    sim_free(order);
+    sim_free(sort_scratch);
+    sim_free(arrival_prefix);
+    return ok;
+}
+
+// Menu option: interactive process list par race.
+void race_all_algorithms() {
+    if (process_count == 0) {
+        printf("\n[ERROR] No processes to compare. Please add processes first.\n");
+        return;
+    }
+    int time_quantum;
+    printf("\nEnter Time Quantum for Round Robin: ");
+    if (scanf("%d", &time_quantum) != 1 || time_quantum <= 0) {
+        printf("[ERROR] Invalid time quantum. Must be a positive integer.\n");
+        discard_input_line();
+        return;
+    }
+    race_policies(processes, process_count, time_quantum);
+}
+
+// "--race <workload> [quantum]"
+int run_race(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s --race <workload file> [quantum]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2;
+    bool quantum_seen = false;
+    for (int i = 3; i < argc; i++) {
+        if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) return 2;
+    }
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[2], &w)) return 1;
+    if (w.count == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        workload_free(&w);
+        return 1;
+    }
+    bool ok = race_policies(w.procs, w.count, time_quantum);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+
+// --- Fused Multi-Policy Mode ---
+// Ek hi pass mein trace padhkar saari chuni hui policies ko saath-saath feed karta hai, taaki badi
+// trace har policy ke liye dobara padhi aur parse na ho. Input arrival order mein hona chahiye.
+// Saari policies work-conserving hain, isliye busy periods (CPU lagataar busy rehne ke hisse) har
+// policy ke liye same hote hain: busy period khatam hone par uske saare processes har policy mein
+// poore ho chuke hote hain. Isliye arrivals ek segment mein jama hote hain aur band busy periods
+// ke baad segment har policy ke engine par chala kar chhod diya jaata hai. Memory sabse lambe busy
+// period (ya FUSED_SEGMENT_PROCESSES) jitni hi lagti hai, poori trace jitni nahi.
+
+typedef struct {
+    Policy policy;
+    Process* procs;           // Segment ki is policy wali copy (engine ise badalta hai)
+    long long count;
+    long long sum_waiting;
+    long long sum_turnaround;
+    long long sum_response;
+    int max_waiting;
+    bool ok;
+} FusedPolicy;
+
+// Segment ke processes har policy ke engine par chalata hai aur totals mein jodta hai.
+static void fused_flush(const Workload* segment, FusedPolicy policies[], int policy_count, int time_quantum) {
+    if (segment->count == 0) return;
+    #pragma omp parallel for schedule(static, 1) if (segment->count >= 4096)
+    for (int k = 0; k < policy_count; k++) {
+        FusedPolicy* fp = &policies[k];
+        if (!fp->ok) continue;
+        memcpy(fp->procs, segment->procs, (size_t)segment->count * sizeof(Process));
+        SimEngine engine;
+        if (!engine_init(&engine, fp->policy, time_quantum, fp->procs, segment->count, false)) {
+            fp->ok = false;
+            continue;
+        }
+        while (engine_step(&engine));
+        fp->count += segment->count;
+        fp->sum_waiting += engine.sum_waiting;
+        fp->sum_turnaround += engine.sum_turnaround;
+        for (int i = 0; i < segment->count; i++) {
+            fp->sum_response += fp->procs[i].response_time;
+            if (fp->procs[i].waiting_time > fp->max_waiting) fp->max_waiting = fp->procs[i].waiting_time;
+        }
+        engine_free(&engine);
+    }
+}
+
+// Policies ki comma-separated list ("fcfs,sjf" ya "all") parse karta hai.
+static int parse_policy_list(const char* list, Policy out[]) {
+    if (strcmp(list, "all") == 0) {
+        for (int i = 0; i < POLICY_COUNT; i++) out[i] = (Policy)i;
+        return POLICY_COUNT;
+    }
+    int count = 0;
+    char name[32];
+    while (*list != '\0') {
+        size_t len = strcspn(list, ",");
+        if (len == 0 || len >= sizeof(name) || count == POLICY_COUNT) return 0;
+        memcpy(name, list, len);
+        name[len] = '\0';
+        if (!parse_policy(name, &out[count])) return 0;
+        for (int i = 0; i < count; i++) {
+            if (out[i] == out[count]) return 0;
+        }
+        count++;
+        list += len;
+        if (*list == ',') list++;
+    }
+    return count;
+}
+
+// "--fused <workload|-> [quantum] [--policies fcfs,sjf,priority,rr]"
+int run_fused(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s --fused <workload file|-> [quantum] [--policies fcfs,sjf,priority,rr|all] [--merge file]...\n"
+               "       [--compress F] [--scale-burst F] [--filter EXPR] [--sample P] [--seed s]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2;
+    bool quantum_seen = false;
+    Policy selected[POLICY_COUNT];
+    int policy_count = parse_policy_list("all", selected);
+    const char* paths[TRACE_MAX_INPUTS];
+    int path_count = 0;
+    paths[path_count++] = argv[2];
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--policies") == 0 && i + 1 < argc) {
+            policy_count = parse_policy_list(argv[++i], selected);
+            if (policy_count == 0) {
+                printf("[ERROR] Invalid policy list '%s'.\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--merge") == 0 && i + 1 < argc) {
+            if (path_count == TRACE_MAX_INPUTS) {
+                printf("[ERROR] At most %d inputs can be merged.\n", TRACE_MAX_INPUTS);
+                return 2;
+            }
+            paths[path_count++] = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            i++; // Trace operator; pipeline khulne ke baad jodte (aur anjaane option pakadte) hain
+        } else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) {
+            return 2;
+        }
+    }
+    if (time_quantum <= 0) {
+        printf("[ERROR] Invalid time quantum. Must be a positive integer.\n");
+        return 2;
+    }
+
+    // Input(s) trace pipeline se aate hain: merge aur operators bina intermediate file ke.
+    TracePipeline stream;
+    if (!trace_pipeline_open(&stream, paths, path_count)) return 1;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--policies") == 0 || strcmp(argv[i], "--merge") == 0) { i++; continue; }
+        int used = trace_pipeline_option(&stream, argc, argv, &i);
+        if (used < 0 || (used == 0 && argv[i][0] == '-' && argv[i][1] == '-')) {
+            if (used == 0) printf("[ERROR] Unknown option '%s'.\n", argv[i]);
+            trace_pipeline_close(&stream);
+            return 2;
+        }
+    }
+
+    FusedPolicy policies[POLICY_COUNT];
+    Workload batch, segment;
+    workload_init(&batch);
+    workload_init(&segment);
+    int procs_capacity = 0;
+    for (int k = 0; k < policy_count; k++) {
+        memset(&policies[k], 0, sizeof(policies[k]));
+        policies[k].policy = selected[k];
+        policies[k].ok = true;
+    }
+
+    double started = wall_seconds();
+    long long busy_until = 0;    // Khule busy period ka end
+    int last_arrival = 0;
+    long long busy_periods = 0;
+    int longest_period = 0, period_start = 0;
+    bool ok = true;
+
+    while (ok) {
+        ok = trace_pipeline_next(&stream, &batch);
+        bool end_of_input = (batch.count == 0);
+
+        for (int i = 0; ok && i <= batch.count; i++) {
+            const Process* p = (i < batch.count) ? &batch.procs[i] : NULL;
+            if (p != NULL && p->arrival_time < last_arrival) {
+                printf("[ERROR] Process %d arrives at %d, before the previous arrival at %d. --fused needs a trace sorted by arrival time.\n",
+                       p->pid, p->arrival_time, last_arrival);
+                ok = false;
+                break;
+            }
+            if (p == NULL && !end_of_input) break;
+
+            // Naya busy period shuru: pichhle saare processes har policy mein poore ho chuke hain.
+            if (segment.count > 0 && (p == NULL || p->arrival_time >= busy_until)) {
+                busy_periods++;
+                if (segment.count - period_start > longest_period) longest_period = segment.count - period_start;
+                if (p == NULL || segment.count >= FUSED_SEGMENT_PROCESSES) {
+                    fused_flush(&segment, policies, policy_count, time_quantum);
+                    segment.count = 0;
+                }
+                period_start = segment.count;
+            }
+            if (p == NULL) break;
+
+            if (segment.count == procs_capacity) {
+                int new_capacity = (procs_capacity == 0) ? 1024 : procs_capacity * 2;
+                for (int k = 0; ok && k < policy_count; k++) {
+                    Process* grown = sim_realloc(policies[k].procs, (size_t)new_capacity * sizeof(Process), MEM_PROCESS_TABLE);
+                    if (grown == NULL) ok = false;
+                    else policies[k].procs = grown;
+                }
+                if (!ok) {
+                    printf("[ERROR] Failed to allocate memory for a busy period of %d processes.\n", segment.count);
+                    break;
+                }
+                procs_capacity = new_capacity;
+            }
+            if (!workload_append(&segment, p->arrival_time, p->burst_time, p->priority)) {
+                printf("[ERROR] Failed to allocate memory for a busy period of %d processes.\n", segment.count);
+                ok = false;
+                break;
+            }
+            segment.procs[segment.count - 1].pid = p->pid;
+            last_arrival = p->arrival_time;
+            busy_until = ((p->arrival_time > busy_until) ? p->arrival_time : busy_until) + p->burst_time;
+            if (busy_until > INT_MAX) {
+                printf("[ERROR] Workload '%s' is too long to simulate.\n", argv[2]);
+                ok = false;
+            }
+        }
+        if (end_of_input) break;
+    }
+    for (int k = 0; ok && k < policy_count; k++) {
+        if (!policies[k].ok) {
+            printf("[ERROR] Failed to allocate memory for the simulation.\n");
+            ok = false;
+        }
+    }
+
+    if (ok && stream.produced == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        ok = false;
+    }
+    if (ok) {
+        printf("\n--- FUSED RUN: %lld processes read once (%lld after transforms), %d policies, quantum %d ---\n",
+               stream.consumed, stream.produced, policy_count, time_quantum);
+        printf("+----------+------------------+---------------------+-------------------+-------------+\n");
+        printf("| Policy   | Avg Waiting Time | Avg Turnaround Time | Avg Response Time | Max Waiting |\n");
+        printf("+----------+------------------+---------------------+-------------------+-------------+\n");
+        for (int k = 0; k < policy_count; k++) {
+            FusedPolicy* fp = &policies[k];
+            printf("| %-8s | %-16.2f | %-19.2f | %-17.2f | %-11d |\n", policy_name(fp->policy),
+                   (double)fp->sum_waiting / fp->count, (double)fp->sum_turnaround / fp->count,
+                   (double)fp->sum_response / fp->count, fp->max_waiting);
+        }
+        printf("+----------+------------------+---------------------+-------------------+-------------+\n");
+        printf("| Makespan %lld, %lld busy periods (longest %d processes), %.3f seconds.\n",
+               busy_until, busy_periods, longest_period, wall_seconds() - started);
+        print_memory_report();
+    }
+
+    for (int k = 0; k < policy_count; k++) sim_free(policies[k].procs);
+    workload_free(&segment);
+    workload_free(&batch);
+    trace_pipeline_close(&stream);
+    return ok ? 0 : 1;
+}
+
+// --- Load Sweep (Saturation Knee) ---
+// Workload ke arrival times ko scale karke offered load (utilization) badalta hai: load L par
+// arrival = first + (arrival - first) * base_load / L, jahan base_load = total burst / arrival span.
+// Pehle [min, max] load par SWEEP points ka curve har policy ke liye parallel mein banta hai. Phir jis
+// interval mein p99 waiting time target ko cross karta hai, use har round mein SWEEP_BISECTION_WAYS
+// hisson mein baant kar saare andar ke points parallel mein chalte hain (parallel bisection), jab
+// tak interval tolerance se chhota na ho jaaye.
+
+#define SWEEP_BISECTION_WAYS 8
+
+typedef struct {
+    Policy policy;
+    double load;
+    double avg_waiting;
+    int p99_waiting;
+    bool ok;
+} SweepPoint;
+
+// values[0..n) mein k-th sabse chhota element (quickselect; array ka order badal jaata hai).
+int select_kth(int values[], int n, int k) {
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int pivot = values[lo + (hi - lo) / 2];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (values[i] < pivot) i++;
+            while (values[j] > pivot) j--;
+            if (i <= j) {
+                int t = values[i]; values[i] = values[j]; values[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+    return values[k];
+}
+
+// Ek (policy, load) point simulate karta hai. Har call apni copy par chalta hai, isliye thread-safe hai.
+static void sweep_evaluate(const Workload* w, int first_arrival, double base_load, int time_quantum, SweepPoint* pt) {
+    int n = w->count;
+    pt->ok = false;
+    Process* procs = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+    int* waits = sim_malloc((size_t)n * sizeof(int), MEM_METRICS);
+    if (procs == NULL || waits == NULL) {
+        sim_free(procs);
+        sim_free(waits);
+        return;
+    }
+    double stretch = base_load / pt->load;
+    long long latest = 0, total_burst = 0;
+    for (int i = 0; i < n; i++) {
+        procs[i] = w->procs[i];
+        long long arrival = first_arrival + llround((w->procs[i].arrival_time - first_arrival) * stretch);
+        if (arrival > latest) latest = arrival;
+        total_burst += procs[i].burst_time;
+        procs[i].arrival_time = (arrival > INT_MAX) ? INT_MAX : (int)arrival;
+    }
+
+    SimEngine engine;
+    if (latest + total_burst <= INT_MAX && engine_init(&engine, pt->policy, time_quantum, procs, n, false)) {
+        while (engine_step(&engine));
+        for (int i = 0; i < n; i++) waits[i] = procs[i].waiting_time;
+        pt->avg_waiting = (double)engine.sum_waiting / n;
+        pt->p99_waiting = select_kth(waits, n, (int)((n * 99LL + 99) / 100) - 1); // Nearest-rank p99
+        pt->ok = true;
+        engine_free(&engine);
+    }
+    sim_free(procs);
+    sim_free(waits);
+}
+
+static void sweep_evaluate_all(const Workload* w, int first_arrival, double base_load, int time_quantum,
+                               SweepPoint points[], int count) {
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < count; i++) sweep_evaluate(w, first_arrival, base_load, time_quantum, &points[i]);
+}
+
+// "--sweep <workload> [quantum] [--policies list] [--target-p99 T] [--min-load a] [--max-load b]
+//  [--points N] [--tolerance t]"
+int run_sweep(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s --sweep <workload> [quantum] [--policies fcfs,sjf,priority,rr|all] [--target-p99 T]\n"
+               "       [--min-load a] [--max-load b] [--points N] [--tolerance t]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2, point_count = 10;
+    bool quantum_seen = false;
+    double target = -1, min_load = 0.1, max_load = 0.99, tolerance = 0.005;
+    Policy selected[POLICY_COUNT];
+    int policy_count = parse_policy_list("all", selected);
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--policies") == 0 && i + 1 < argc) policy_count = parse_policy_list(argv[++i], selected);
+        else if (strcmp(argv[i], "--target-p99") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &target)) return 2; }
+        else if (strcmp(argv[i], "--min-load") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &min_load)) return 2; }
+        else if (strcmp(argv[i], "--max-load") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &max_load)) return 2; }
+        else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &point_count)) return 2; }
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &tolerance)) return 2; }
+        else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) return 2;
+    }
+    if (policy_count == 0 || time_quantum <= 0 || point_count < 2 || min_load <= 0 || max_load <= min_load || tolerance <= 0) {
+        printf("[ERROR] Invalid sweep options. Loads must satisfy 0 < min < max, points >= 2, quantum > 0.\n");
+        return 2;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[2], &w)) return 1;
+    int first_arrival = INT_MAX, last_arrival = 0;
+    long long total_burst = 0;
+    for (int i = 0; i < w.count; i++) {
+        if (w.procs[i].arrival_time < first_arrival) first_arrival = w.procs[i].arrival_time;
+        if (w.procs[i].arrival_time > last_arrival) last_arrival = w.procs[i].arrival_time;
+        total_burst += w.procs[i].burst_time;
+    }
+    if (w.count < 2 || last_arrival == first_arrival) {
+        printf("[ERROR] Load sweep needs at least two processes with different arrival times.\n");
+        workload_free(&w);
+        return 1;
+    }
+    double base_load = (double)total_burst / (last_arrival - first_arrival);
+    if (target < 0) target = 10.0 * total_burst / w.count; // Default: 10x average burst
+
+    // Curve: policies x points, sab parallel.
+    int curve_count = policy_count * point_count;
+    SweepPoint* curve = sim_malloc((size_t)curve_count * sizeof(SweepPoint), MEM_METRICS);
+    SweepPoint* probes = sim_malloc((size_t)policy_count * (SWEEP_BISECTION_WAYS - 1) * sizeof(SweepPoint), MEM_METRICS);
+    if (curve == NULL || probes == NULL) {
+        printf("[ERROR] Failed to allocate memory for the sweep.\n");
+        sim_free(curve);
+        sim_free(probes);
+        workload_free(&w);
+        return 1;
+    }
+    for (int k = 0; k < policy_count; k++) {
+        for (int j = 0; j < point_count; j++) {
+            SweepPoint* pt = &curve[k * point_count + j];
+            pt->policy = selected[k];
+            pt->load = min_load + (max_load - min_load) * j / (point_count - 1);
+        }
+    }
+    double started = wall_seconds();
+    sweep_evaluate_all(&w, first_arrival, base_load, time_quantum, curve, curve_count);
+
+    printf("\n--- LOAD SWEEP: %d processes, trace load %.3f, target p99 waiting %.1f ---\n", w.count, base_load, target);
+    bool ok = true;
+    for (int k = 0; k < policy_count; k++) {
+        printf("\n%s\n", policy_name(selected[k]));
+        printf("+--------+------------------+------------------+\n");
+        printf("| Load   | Avg Waiting Time | P99 Waiting Time |\n");
+        printf("+--------+------------------+------------------+\n");
+        for (int j = 0; j < point_count; j++) {
+            const SweepPoint* pt = &curve[k * point_count + j];
+            if (!pt->ok) {
+                printf("| %-6.3f | (failed: memory or time overflow)   |\n", pt->load);
+                ok = false;
+                continue;
+            }
+            printf("| %-6.3f | %-16.2f | %-16d |%s\n", pt->load, pt->avg_waiting, pt->p99_waiting,
+                   (pt->p99_waiting > target) ? " above target" : "");
+        }
+        printf("+--------+------------------+------------------+\n");
+    }
+
+    // Har policy ka bracket: aakhri load jahan p99 <= target, aur uske baad ka pehla load jahan > target.
+    double lo[POLICY_COUNT], hi[POLICY_COUNT];
+    bool refining[POLICY_COUNT];
+    for (int k = 0; k < policy_count; k++) {
+        refining[k] = false;
+        for (int j = 0; j < point_count; j++) {
+            const SweepPoint* pt = &curve[k * point_count + j];
+            if (pt->ok && pt->p99_waiting > target) {
+                if (j > 0) {
+                    lo[k] = curve[k * point_count + j - 1].load;
+                    hi[k] = pt->load;
+                    refining[k] = true;
+                } else {
+                    lo[k] = hi[k] = -1; // Sabse kam load par bhi target ke upar
+                }
+                break;
+            }
+            lo[k] = hi[k] = 0; // Poore range mein target ke neeche
+        }
+    }
+
+    // Parallel bisection: har round mein saari policies ke bracket ke andar ke points ek saath chalte hain.
+    int rounds = 0;
+    while (ok) {
+        int count = 0;
+        for (int k = 0; k < policy_count; k++) {
+            if (!refining[k] || hi[k] - lo[k] <= tolerance) continue;
+            for (int s = 1; s < SWEEP_BISECTION_WAYS; s++) {
+                probes[count].policy = selected[k];
+                probes[count].load = lo[k] + (hi[k] - lo[k]) * s / SWEEP_BISECTION_WAYS;
+                count++;
+            }
+        }
+        if (count == 0) break;
+        sweep_evaluate_all(&w, first_arrival, base_load, time_quantum, probes, count);
+        rounds++;
+        for (int k = 0, p = 0; k < policy_count; k++) {
+            if (!refining[k] || hi[k] - lo[k] <= tolerance) continue;
+            double new_lo = lo[k], new_hi = hi[k];
+            for (int s = 0; s < SWEEP_BISECTION_WAYS - 1; s++, p++) {
+                if (!probes[p].ok) ok = false;
+                else if (probes[p].p99_waiting <= target && probes[p].load > new_lo && new_hi == hi[k]) new_lo = probes[p].load;
+                else if (probes[p].p99_waiting > target && new_hi == hi[k]) new_hi = probes[p].load;
+            }
+            lo[k] = new_lo;
+            hi[k] = new_hi;
+        }
+    }
+
+    printf("\n--- SATURATION KNEE (p99 waiting > %.1f) ---\n", target);
+    for (int k = 0; ok && k < policy_count; k++) {
+        if (refining[k]) {
+            printf("| %-8s : load %.3f (between %.3f and %.3f)\n", policy_name(selected[k]), (lo[k] + hi[k]) / 2, lo[k], hi[k]);
+        } else if (lo[k] < 0) {
+            printf("| %-8s : above target already at load %.3f\n", policy_name(selected[k]), min_load);
+        } else {
+            printf("| %-8s : below target up to load %.3f\n", policy_name(selected[k]), max_load);
+        }
+    }
+    if (!ok) printf("[ERROR] Some sweep points failed (out of memory or scaled times overflow).\n");
+    printf("| %d curve points + %d bisection rounds in %.3f seconds.\n", curve_count, rounds, wall_seconds() - started);
+
+    sim_free(curve);
+    sim_free(probes);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+// --- Multi-CPU Simulation ---
+// Ek global ready structure (single-CPU engine wala hi: queue ya heap) aur 'cpus' processors.
+// Har CPU par chal rahe slice ka end ek event queue (finish: time = slice end, id = CPU, aux = generation)
+// mein rehta hai, jiska backend dynamic arrivals jaisa hi event_queue_default hai. Preemptive policies ke
+// liye chal rahe processes ki ek max-heap (victim) bhi hai: naya behtar process aane par sabse
+// kharab chal raha process hataya jaata hai. SJF mein saare chal rahe processes ka remaining time
+// ek hi rate se ghatta hai, isliye unka order slice end se hi pata chal jaata hai.
+// Dono mein purani entries (preempt ya poore ho chuke slices) generation number se pehchaan kar
+// lazily hata di jaati hain. cpus = 1 par results single-CPU engine jaise hi hote hain.
+
+typedef struct {
+    long long key;
+    int index;      // Process index (tie-break)
+    int cpu;
+    int gen;
+} CpuSlot;
+
+// Chal rahe processes ki max-heap (sabse kharab top par).
+typedef struct {
+    CpuSlot* items;
+    int count;
+    int capacity;
+} CpuSlotHeap;
+
+typedef struct {
+    int running;    // Process index, -1 = idle
+    int run_start;
+    int slice_end;
+    int gen;        // Har dispatch/preempt par badhta hai; heap entries isse match karni chahiye
+} CpuState;
+
+static bool cpu_slot_before(const CpuSlot* a, const CpuSlot* b) {
+    if (a->key != b->key) return a->key > b->key;
+    return a->index > b->index;
+}
+
+static void cpu_slot_sift_down(CpuSlotHeap* h, int i) {
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= h->count) break;
+        if (child + 1 < h->count && cpu_slot_before(&h->items[child + 1], &h->items[child])) child++;
+        if (!cpu_slot_before(&h->items[child], &h->items[i])) break;
+        CpuSlot t = h->items[i]; h->items[i] = h->items[child]; h->items[child] = t;
+        i = child;
+    }
+}
+
+static void cpu_slot_pop(CpuSlotHeap* h) {
+    h->items[0] = h->items[--h->count];
+    cpu_slot_sift_down(h, 0);
+}
+
+// Capacity pehle se 2 * cpus + 16 hai aur compaction usse upar nahi jaane deta, isliye push fail nahi hota.
+static void cpu_slot_push(CpuSlotHeap* h, CpuSlot slot) {
+    int i = h->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!cpu_slot_before(&slot, &h->items[parent])) break;
+        h->items[i] = h->items[parent];
+        i = parent;
+    }
+    h->items[i] = slot;
+}
+
+static bool cpu_slot_stale(const CpuSlot* slot, const CpuState cpu_state[]) {
+    return cpu_state[slot->cpu].gen != slot->gen;
+}
+
+// Top par se purani entries hatata hai; bahut jama ho jaayein toh heap ko live entries se dobara banata hai.
+static void cpu_slot_clean(CpuSlotHeap* h, const CpuState cpu_state[]) {
+    while (h->count > 0 && cpu_slot_stale(&h->items[0], cpu_state)) cpu_slot_pop(h);
+    if (h->count < h->capacity - 1) return;
+    int live = 0;
+    for (int i = 0; i < h->count; i++) {
+        if (!cpu_slot_stale(&h->items[i], cpu_state)) h->items[live++] = h->items[i];
+    }
+    h->count = live;
+    for (int i = live / 2 - 1; i >= 0; i--) cpu_slot_sift_down(h, i);
+}
+
+// Finish queue ke top par se purane slices hatata hai.
+static void finish_clean(EventQueue* finish, const CpuState cpu_state[]) {
+    const QueuedEvent* top;
+    while ((top = event_queue_top(finish)) != NULL && cpu_state[top->id].gen != top->aux) event_queue_pop(finish);
+}
+
+// Memory na mile (finish queue badh na sake) toh false.
+static bool multi_dispatch(SimEngine* e, CpuState cpu_state[], EventQueue* finish, CpuSlotHeap* victims, int cpu, int idx) {
+    Process* p = &e->procs[idx];
+    CpuState* c = &cpu_state[cpu];
+    if (p->remaining_time == p->burst_time) p->response_time = e->current_time - p->arrival_time;
+    account_dispatch(e, &e->cpu_stats[cpu], p);
+    int slice = p->remaining_time;
+    if (e->policy == POLICY_RR && e->time_quantum < slice) slice = e->time_quantum;
+    c->running = idx;
+    c->run_start = e->current_time;
+    c->slice_end = e->current_time + slice;
+    c->gen++;
+    if (victims != NULL) {
+        cpu_slot_clean(victims, cpu_state);
+        long long key = (e->policy == POLICY_SJF) ? c->slice_end : p->priority;
+        cpu_slot_push(victims, (CpuSlot){ key, idx, cpu, c->gen });
+    }
+    return event_queue_push(finish, (QueuedEvent){ c->slice_end, cpu, c->gen });
+}
+
+// Kya ready heap ka top chal rahe process 'running' (jiska slice 'slice_end' par khatam hoga) se behtar hai?
+// Single-CPU engine ke engine_less jaisa hi: SJF mein remaining time, Priority mein priority, tie par index.
+static bool multi_ready_beats(const SimEngine* e, int ready_idx, int running_idx, int slice_end) {
+    long long ready_key, running_key;
+    if (e->policy == POLICY_SJF) {
+        ready_key = e->procs[ready_idx].remaining_time;
+        running_key = slice_end - e->current_time;
+    } else {
+        ready_key = e->procs[ready_idx].priority;
+        running_key = e->procs[running_idx].priority;
+    }
+    if (ready_key != running_key) return ready_key < running_key;
+    return ready_idx < running_idx;
+}
+
+// engine_init se bane engine ko 'cpus' processors par poora chalata hai. Memory na mile toh false.
+bool engine_run_multi(SimEngine* e, int cpus) {
+    bool preemptive = (e->policy == POLICY_SJF || e->policy == POLICY_PRIORITY);
+    CpuState* cpu_state = sim_malloc((size_t)cpus * sizeof(CpuState), MEM_QUEUES);
+    int* idle = sim_malloc((size_t)cpus * sizeof(int), MEM_QUEUES);
+    int* requeue = sim_malloc((size_t)cpus * sizeof(int), MEM_QUEUES);
+    EventQueue finish;
+    CpuSlotHeap victims = { NULL, 0, 2 * cpus + 16 };
+    bool finish_ok = event_queue_init(&finish, event_queue_default, 2 * cpus + 16);
+    if (preemptive) victims.items = sim_malloc((size_t)victims.capacity * sizeof(CpuSlot), MEM_QUEUES);
+    bool ok = (cpu_state != NULL && idle != NULL && requeue != NULL && finish_ok && (!preemptive || victims.items != NULL));
+    if (ok && cpus > e->cpu_count) {
+        CpuSchedStat* grown = sim_realloc(e->cpu_stats, (size_t)cpus * sizeof(CpuSchedStat), MEM_METRICS);
+        if (grown == NULL) ok = false;
+        else e->cpu_stats = grown;
+    }
+    if (ok) {
+        memset(e->cpu_stats, 0, (size_t)cpus * sizeof(CpuSchedStat));
+        e->cpu_count = cpus;
+    }
+
+    int idle_count = 0;
+    for (int c = cpus - 1; ok && c >= 0; c--) {
+        cpu_state[c].running = -1;
+        cpu_state[c].gen = 0;
+        idle[idle_count++] = c;
+    }
+
+    while (ok && e->completed + e->dropped < e->n) {
+        finish_clean(&finish, cpu_state);
+        long long next_finish = (finish.count > 0) ? event_queue_top(&finish)->time : LLONG_MAX;
+        // Non-preemptive policies mein arrival sirf khali CPU hone par event hai; baaki waqt
+        // processes agle finish par arrival order mein admit ho jaate hain.
+        int arrival_time = engine_next_arrival_time(e);
+        long long next_arrival = (arrival_time != INT_MAX && (preemptive || idle_count > 0)) ? arrival_time : LLONG_MAX;
+
+        if (next_finish <= next_arrival) {
+            e->current_time = (int)next_finish;
+            // Is time par khatam hone wale saare slices, phir is time tak ke arrivals. RR ke preempt hue
+            // processes sabse aakhir mein queue hote hain, taaki completion hooks se isi time par aaye
+            // dynamic arrivals bhi unse pehle rahein.
+            int requeue_count = 0;
+            while (finish.count > 0 && event_queue_top(&finish)->time == e->current_time) {
+                int cpu = event_queue_pop(&finish).id;
+                CpuState* c = &cpu_state[cpu];
+                int idx = c->running;
+                Process* p = &e->procs[idx];
+                p->remaining_time -= e->current_time - c->run_start;
+                e->busy_time += e->current_time - c->run_start;
+                e->events++;
+                if (e->on_interval != NULL) e->on_interval(e->hook_ctx, p->pid, c->run_start, e->current_time);
+                account_interval_end(e, &e->cpu_stats[cpu], p, c->run_start, false);
+                c->running = -1;
+                c->gen++;
+                idle[idle_count++] = cpu;
+                engine_admit(e, e->current_time);
+                if (p->remaining_time == 0) engine_complete(e, idx);
+                else requeue[requeue_count++] = idx; // Sirf RR: slice ke dauran aaye processes pehle
+                finish_clean(&finish, cpu_state);
+            }
+            engine_admit(e, e->current_time);
+            for (int k = 0; k < requeue_count; k++) {
+                if (e->ready_count > 0) e->procs[requeue[k]].preemptions++; // Koi aur pehle se intezaar mein tha
+                ready_push(e, requeue[k]);
+            }
+        } else {
+            e->current_time = (int)next_arrival;
+            e->events++;
+        }
+        engine_admit(e, e->current_time);
+
+        // Khali CPUs bharo; preemptive policies mein behtar ready process sabse kharab chal rahe ko hatata hai.
+        while (ok && e->ready_count > 0) {
+            if (idle_count > 0) {
+                ok = multi_dispatch(e, cpu_state, &finish, preemptive ? &victims : NULL, idle[--idle_count], ready_pop(e));
+                continue;
+            }
+            if (!preemptive) break;
+            cpu_slot_clean(&victims, cpu_state);
+            int cpu = victims.items[0].cpu;
+            CpuState* c = &cpu_state[cpu];
+            if (!multi_ready_beats(e, ready_top(e), c->running, c->slice_end)) break;
+            int preempted = c->running;
+            Process* p = &e->procs[preempted];
+            p->remaining_time -= e->current_time - c->run_start;
+            e->busy_time += e->current_time - c->run_start;
+            if (e->on_interval != NULL) e->on_interval(e->hook_ctx, p->pid, c->run_start, e->current_time);
+            account_interval_end(e, &e->cpu_stats[cpu], p, c->run_start, true);
+            c->running = -1;
+            c->gen++;
+            heap_push(e, preempted);
+            ok = multi_dispatch(e, cpu_state, &finish, &victims, cpu, heap_pop(e));
+        }
+    }
+
+    // Aakhri completion tak jo CPUs khali rahe, unka bacha idle time.
+    for (int c = 0; ok && c < cpus; c++) {
+        e->cpu_stats[c].idle_time += e->current_time - e->cpu_stats[c].idle_since;
+        e->cpu_stats[c].idle_since = e->current_time;
+    }
+
+    sim_free(cpu_state);
+    sim_free(idle);
+    sim_free(requeue);
+    event_queue_free(&finish);
+    sim_free(victims.items);
+    return ok;
+}
+
+// --- Capacity Search (Minimum CPUs for an SLO) ---
+// Sabse kam CPUs dhoondhta hai jin par chuna hua percentile (e.g. p99 response) target se kam ya
+// barabar ho. CPUs badhane se latency nahi badhti (monotonic maana gaya hai), isliye:
+//  - Galloping: jab tak koi pass karne wali value na mile, har round CAPACITY_PROBES aage ke
+//    doubling points (1, 2, 4, 8, ...) parallel mein chalte hain.
+//  - Phir (aakhri fail, pehla pass) ke beech ko CAPACITY_PROBES + 1 hisson mein baant kar parallel
+//    search, jab tak dono pados ke na ho jaayein.
+// Jo count kisi pass se bada ya kisi fail se chhota hai woh kabhi chalaya nahi jaata. Upar ki seema
+// workload ki max concurrency hai: utne CPUs par koi process intezaar nahi karta.
+
+#define CAPACITY_PROBES 4
+
+typedef struct {
+    int cpus;
+    int value;      // Percentile metric
+    bool ok;
+} CapacityProbe;
+
+// Ek saath system mein (bina intezaar ke) zyada se zyada kitne processes ho sakte hain.
+static int max_concurrency(const Workload* w) {
+    int n = w->count;
+    long long* starts = sim_malloc((size_t)n * sizeof(long long), MEM_METRICS);
+    long long* ends = sim_malloc((size_t)n * sizeof(long long), MEM_METRICS);
+    int best = n; // Memory na mile toh safe upper bound
+    if (starts != NULL && ends != NULL) {
+        for (int i = 0; i < n; i++) {
+            starts[i] = w->procs[i].arrival_time;
+            ends[i] = (long long)w->procs[i].arrival_time + w->procs[i].burst_time;
+        }
+        qsort(starts, n, sizeof(long long), compare_long_long);
+        qsort(ends, n, sizeof(long long), compare_long_long);
+        best = 0;
+        for (int i = 0, j = 0, active = 0; i < n; i++) {
+            while (ends[j] <= starts[i]) { j++; active--; }
+            active++;
+            if (active > best) best = active;
+        }
+    }
+    sim_free(starts);
+    sim_free(ends);
+    return best;
+}
+
+// metric: 0 response, 1 waiting, 2 turnaround.
+int slo_metric(const Process* p, int metric) {
+    if (metric == 0) return p->response_time;
+    if (metric == 1) return p->waiting_time;
+    return p->turnaround_time;
+}
+
+static void capacity_evaluate(const Workload* w, Policy policy, int time_quantum, int metric, double percentile,
+                              CapacityProbe* probe) {
+    int n = w->count;
+    probe->ok = false;
+    Process* procs = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+    int* values = sim_malloc((size_t)n * sizeof(int), MEM_METRICS);
+    SimEngine engine;
+    if (procs != NULL && values != NULL) {
+        memcpy(procs, w->procs, (size_t)n * sizeof(Process));
+        if (engine_init(&engine, policy, time_quantum, procs, n, false)) {
+            if (engine_run_multi(&engine, probe->cpus)) {
+                for (int i = 0; i < n; i++) values[i] = slo_metric(&procs[i], metric);
+                long long rank = (long long)ceil(percentile / 100.0 * n);
+                if (rank < 1) rank = 1;
+                probe->value = select_kth(values, n, (int)rank - 1);
+                probe->ok = true;
+            }
+            engine_free(&engine);
+        }
+    }
+    sim_free(procs);
+    sim_free(values);
+}
+
+// "--min-cpus <workload> <policy> --target X [--metric response|waiting|turnaround] [--percentile p]
+//  [--event-queue backend] [quantum]"
+int run_min_cpus(int argc, char* argv[]) {
+    static const char* const metrics[] = { "response", "waiting", "turnaround" };
+    Policy policy;
+    if (argc < 4 || !parse_policy(argv[3], &policy)) {
+        printf("Usage: %s --min-cpus <workload> <fcfs|sjf|priority|rr> --target X [--metric response|waiting|turnaround]\n"
+               "       [--percentile p] [--event-queue binary|4ary|calendar|radix] [quantum]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2, metric = 0;
+    bool quantum_seen = false;
+    double target = -1, percentile = 99;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            if (!parse_option_double(argv, &i, &target)) return 2;
+        } else if (strcmp(argv[i], "--event-queue") == 0 && i + 1 < argc) {
+            EventQueueBackend backend;
+            if (!parse_event_queue_backend(argv[++i], &backend)) {
+                printf("[ERROR] Unknown event queue '%s' (binary, 4ary, calendar or radix).\n", argv[i]);
+                return 2;
+            }
+            event_queue_set_default(backend);
+        } else if (strcmp(argv[i], "--percentile") == 0 && i + 1 < argc) {
+            if (!parse_option_double(argv, &i, &percentile)) return 2;
+        } else if (strcmp(argv[i], "--metric") == 0 && i + 1 < argc) {
+            i++;
+            metric = -1;
+            for (int m = 0; m < 3; m++) {
+                if (strcmp(argv[i], metrics[m]) == 0) metric = m;
+            }
+        } else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) {
+            return 2;
+        }
+    }
+    if (target < 0 || metric < 0 || percentile <= 0 || percentile > 100 || time_quantum <= 0) {
+        printf("[ERROR] Need --target >= 0, a known --metric, 0 < percentile <= 100 and a positive quantum.\n");
+        return 2;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[2], &w)) return 1;
+    if (w.count == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        workload_free(&w);
+        return 1;
+    }
+
+    double started = wall_seconds();
+    int cap = max_concurrency(&w);
+    int fail = 0, pass = -1;   // Sabse bada fail count, sabse chhota pass count (-1 = abhi nahi mila)
+    bool ok = true;
+    printf("\n--- MINIMUM CPUs: %s, p%g %s <= %g, %d processes (max concurrency %d) ---\n",
+           policy_name(policy), percentile, metrics[metric], target, w.count, cap);
+    printf("+-------+------------+--------+\n");
+    printf("| CPUs  | p%-9g | Result |\n", percentile);
+    printf("+-------+------------+--------+\n");
+
+    while (ok && (pass < 0 || pass - fail > 1)) {
+        CapacityProbe probes[CAPACITY_PROBES];
+        int count = 0;
+        for (int k = 0; k < CAPACITY_PROBES; k++) {
+            int cpus;
+            if (pass < 0) cpus = (fail == 0) ? (1 << k) : fail * (2 << k); // Galloping
+            else cpus = fail + (int)((long long)(pass - fail) * (k + 1) / (CAPACITY_PROBES + 1));
+            if (cpus > cap) cpus = cap;
+            if (cpus <= fail || (pass > 0 && cpus >= pass)) continue;
+            if (count > 0 && probes[count - 1].cpus == cpus) continue;
+            probes[count++].cpus = cpus;
+        }
+        if (count == 0) {
+            // Cap tak sab fail: zyada CPUs se koi fayda nahi.
+            break;
+        }
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int k = 0; k < count; k++) capacity_evaluate(&w, policy, time_quantum, metric, percentile, &probes[k]);
+
+        for (int k = 0; k < count; k++) {
+            if (!probes[k].ok) {
+                printf("[ERROR] Failed to allocate memory for a %d-CPU simulation.\n", probes[k].cpus);
+                ok = false;
+                continue;
+            }
+            bool meets = probes[k].value <= target;
+            printf("| %-5d | %-10d | %-6s |\n", probes[k].cpus, probes[k].value, meets ? "pass" : "fail");
+            if (meets && (pass < 0 || probes[k].cpus < pass)) pass = probes[k].cpus;
+            if (!meets && probes[k].cpus > fail) fail = probes[k].cpus;
+        }
+    }
+    printf("+-------+------------+--------+\n");
+    if (ok && pass > 0) {
+        printf("[RESULT] Minimum CPUs meeting the SLO: %d (%.3f seconds).\n", pass, wall_seconds() - started);
+    } else if (ok) {
+        printf("[RESULT] SLO cannot be met: it fails even with %d CPUs, where no process waits.\n", cap);
+        ok = false;
+    }
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+// --- Closed-Loop Workload Generator ---
+// Open workloads mein saare arrivals pehle se tay hote hain. Closed system mein N clients hain: har
+// client ek job bhejta hai, uske poora hone ka intezaar karta hai, phir "think" karta hai aur agla job
+// bhejta hai. Yahan engine dynamic arrivals par chalta hai: on_complete hook us client ka agla job
+// (completion + think time par) schedule karta hai, isliye arrival rate khud system ki speed par
+// nirbhar hai. Har client count alag simulation hai aur woh parallel mein chalte hain.
+//
+// Think time exponential (mean Z) hai. Service (burst, priority) ya toh ek workload file se random
+// uthaya jaata hai, ya exponential burst (mean S) aur 0-9 ki random priority se banta hai. Pehle
+// CLOSED_WARMUP_PERCENT jobs (submission order mein) warm-up maane jaate hain. Jobs khatam hone par
+// clients ek-ek karke ruk jaate hain, isliye measurement window pehle ruke client par band hoti hai.
+// Window mein poore hue jobs aur window ke end (horizon) par abhi bhi chal rahe jobs dono measure hote
+// hain; chal rahe jobs censored observations hain, unka turnaround horizon tak ki umar (age) maana jaata
+// hai. Isliye starvation mein bhi latency chhupti nahi, aur Avg/p99 turnaround asli ka lower bound hain.
+// Operational bounds ke saath compare karne ke liye: X <= min(N / (D + Z), C / D), jahan D mean
+// service hai, aur Little's law se N = X * (R + Z) hona chahiye. X * (R + Z) N se CLOSED_LITTLE_TOLERANCE
+// se zyada door ho toh run flag hota hai: jobs window ke andar poore hi nahi ho rahe (jaise SJF/Priority
+// mein lambe jobs ki starvation) aur latency numbers par bharosa nahi.
+
+#define CLOSED_WARMUP_PERCENT 10
+#define CLOSED_LITTLE_TOLERANCE 0.10
+
+typedef struct {
+    Policy policy;
+    int time_quantum;
+    int cpus;
+    int jobs;                 // Har simulation mein kul kitne jobs submit honge
+    double think;             // Mean think time (Z)
+    double mean_burst;        // Exponential service ka mean (service == NULL hone par)
+    const Workload* service;  // Burst/priority samples, ya NULL
+    uint64_t seed;
+} ClosedLoopConfig;
+
+typedef struct {
+    int clients;
+    bool ok;
+    long long measured;       // Warm-up ke baad poore hue jobs
+    double throughput;        // Jobs per time unit (X)
+    double mean_turnaround;   // Submit se completion tak (R); in-flight jobs horizon tak ki age se
+    double mean_waiting;
+    int p99_turnaround;
+    double utilization;
+    int in_flight;            // Horizon par submit ho chuke par poore nahi hue jobs
+    int oldest_age;           // Unmein sabse purane job ki horizon tak ki age
+} ClosedLoopPoint;
+
+typedef struct {
+    SimEngine* engine;
+    const ClosedLoopConfig* cfg;
+    int* client_of;           // Har job kis client ka hai
+    int next_job;
+    int exhausted_at;         // Pehli baar kisi client ko job nahi mila (-1 = abhi nahi)
+    uint64_t rng;
+    bool failed;              // Kisi arrival ke liye queue mein memory nahi mili
+} ClosedLoopState;
+
+// Mean 'mean' wala exponential sample, integer time units mein round kiya hua.
+static int closed_exponential(uint64_t* rng, double mean) {
+    if (mean <= 0) return 0;
+    double u = ((sim_random(rng) >> 11) + 1) * (1.0 / 9007199254740993.0); // (0, 1]
+    double x = -mean * log(u) + 0.5;
+    return (x < INT_MAX / 4) ? (int)x : INT_MAX / 4;
+}
+
+// Client ka agla job 'time' par think shuru karke schedule karta hai (jobs khatam hone tak).
+static void closed_submit(ClosedLoopState* st, int client, int time) {
+    const ClosedLoopConfig* cfg = st->cfg;
+    if (st->next_job >= cfg->jobs) {
+        if (st->exhausted_at < 0) st->exhausted_at = time;
+        return;
+    }
+    int idx = st->next_job++;
+    Process* p = &st->engine->procs[idx];
+    p->pid = idx + 1;
+    p->arrival_time = time + closed_exponential(&st->rng, cfg->think);
+    if (cfg->service != NULL) {
+        const Process* s = &cfg->service->procs[sim_random(&st->rng) % (uint64_t)cfg->service->count];
+        p->burst_time = s->burst_time;
+        p->priority = s->priority;
+    } else {
+        int burst = closed_exponential(&st->rng, cfg->mean_burst);
+        p->burst_time = (burst > 0) ? burst : 1;
+        p->priority = (int)(sim_random(&st->rng) % 10);
+    }
+    st->client_of[idx] = client;
+    if (!engine_schedule_arrival(st->engine, idx)) st->failed = true;
+}
+
+static void closed_on_complete(void* ctx, const Process* p) {
+    ClosedLoopState* st = ctx;
+    int idx = p->pid - 1;
+    closed_submit(st, st->client_of[idx], p->completion_time);
+}
+
+// 'pt->clients' clients ke saath ek closed-loop simulation chala kar pt bharta hai.
+static void closed_loop_evaluate(const ClosedLoopConfig* cfg, ClosedLoopPoint* pt) {
+    int n = cfg->jobs;
+    pt->ok = false;
+    Process* procs = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+    int* client_of = sim_malloc((size_t)n * sizeof(int), MEM_METRICS);
+    int* values = sim_malloc((size_t)n * sizeof(int), MEM_METRICS);
+    SimEngine engine;
+    if (procs != NULL && client_of != NULL && values != NULL) {
+        memset(procs, 0, (size_t)n * sizeof(Process));
+        if (engine_init(&engine, cfg->policy, cfg->time_quantum, procs, n, false)) {
+            ClosedLoopState st = { &engine, cfg, client_of, 0, -1, cfg->seed ^ ((uint64_t)pt->clients * 0x9E3779B97F4A7C15ULL), false };
+            bool ok = engine_enable_dynamic_arrivals(&engine);
+            if (ok) {
+                engine.on_complete = closed_on_complete;
+                engine.hook_ctx = &st;
+                for (int c = 0; c < pt->clients; c++) closed_submit(&st, c, 0);
+                if (cfg->cpus > 1) ok = engine_run_multi(&engine, cfg->cpus);
+                else engine_run(&engine);
+                ok = ok && !st.failed;
+            }
+            if (ok) {
+                // Window: warm-up ke baad ke pehle submission se pehle ruke client tak. Clients jobs
+                // se zyada hon toh window bachti hi nahi; tab poora run measure hota hai.
+                long long window_start = procs[(int)((long long)n * CLOSED_WARMUP_PERCENT / 100)].arrival_time;
+                long long window_end = (st.exhausted_at >= 0) ? st.exhausted_at : engine.current_time;
+                if (window_end <= window_start) {
+                    window_start = -1;
+                    window_end = engine.current_time;
+                }
+                long long sum_turnaround = 0, sum_waiting = 0;
+                int measured = 0, in_flight = 0, oldest_age = 0, observed = 0;
+                for (int i = 0; i < n; i++) {
+                    if (procs[i].arrival_time <= window_end && procs[i].completion_time > window_end) {
+                        // Censored: horizon tak ki age. Waiting ka lower bound age - (ab tak chala hissa),
+                        // jo burst se kam ho sakta hai; isliye waiting mein age - burst, kam se kam 0.
+                        int age = (int)(window_end - procs[i].arrival_time);
+                        sum_turnaround += age;
+                        sum_waiting += (age > procs[i].burst_time) ? age - procs[i].burst_time : 0;
+                        values[observed++] = age;
+                        in_flight++;
+                        if (age > oldest_age) oldest_age = age;
+                        continue;
+                    }
+                    if (procs[i].completion_time <= window_start || procs[i].completion_time > window_end) continue;
+                    sum_turnaround += procs[i].turnaround_time;
+                    sum_waiting += procs[i].waiting_time;
+                    values[observed++] = procs[i].turnaround_time;
+                    measured++;
+                }
+                if (measured > 0) {
+                    long long rank = (long long)ceil(0.99 * observed);
+                    pt->measured = measured;
+                    pt->in_flight = in_flight;
+                    pt->oldest_age = oldest_age;
+                    pt->throughput = (double)measured / (window_end - (window_start > 0 ? window_start : 0));
+                    pt->mean_turnaround = (double)sum_turnaround / observed;
+                    pt->mean_waiting = (double)sum_waiting / observed;
+                    pt->p99_turnaround = select_kth(values, observed, (int)rank - 1);
+                    pt->utilization = (engine.current_time > 0) ? (double)engine.busy_time / ((double)engine.current_time * cfg->cpus) : 0;
+                    pt->ok = true;
+                }
+            }
+            engine_free(&engine);
+        }
+    }
+    sim_free(procs);
+    sim_free(client_of);
+    sim_free(values);
+}
+
+// "--closed <policy> --clients N[,N...] --think Z [--burst S | --service workload] [--jobs J] [--cpus C] [--seed s]
+//  [--event-queue backend] [quantum]"
+int run_closed(int argc, char* argv[]) {
+    ClosedLoopConfig cfg = { POLICY_FCFS, 2, 1, 100000, -1, 10, NULL, 12345 };
+    if (argc < 3 || !parse_policy(argv[2], &cfg.policy)) {
+        printf("Usage: %s --closed <fcfs|sjf|priority|rr> --clients N[,N...] --think Z [--burst S | --service workload]\n"
+               "       [--jobs J] [--cpus C] [--seed s] [--event-queue binary|4ary|calendar|radix] [quantum]\n", argv[0]);
+        return 2;
+    }
+    const char* clients_arg = NULL;
+    const char* service_path = NULL;
+    const char* queue_arg = NULL;
+    bool quantum_seen = false;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) clients_arg = argv[++i];
+        else if (strcmp(argv[i], "--think") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &cfg.think)) return 2; }
+        else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &cfg.mean_burst)) return 2; }
+        else if (strcmp(argv[i], "--service") == 0 && i + 1 < argc) service_path = argv[++i];
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &cfg.jobs)) return 2; }
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &cfg.cpus)) return 2; }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) cfg.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--event-queue") == 0 && i + 1 < argc) queue_arg = argv[++i];
+        else if (!parse_quantum_arg(argv[i], &quantum_seen, &cfg.time_quantum)) return 2;
+    }
+    EventQueueBackend backend = SIM_EVENT_QUEUE;
+    if (queue_arg != NULL && !parse_event_queue_backend(queue_arg, &backend)) {
+        printf("[ERROR] Unknown event queue '%s' (binary, 4ary, calendar or radix).\n", queue_arg);
+        return 2;
+    }
+    event_queue_set_default(backend);
+
+    // Client counts: comma-separated list.
+    int counts[64];
+    int count = 0;
+    for (const char* c = clients_arg; c != NULL && *c != '\0' && count < 64; ) {
+        char* end;
+        long value = strtol(c, &end, 10);
+        if (end == c || value <= 0 || value > INT_MAX) { count = 0; break; }
+        counts[count++] = (int)value;
+        c = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') { count = 0; break; }
+    }
+    if (count == 0 || cfg.think < 0 || cfg.mean_burst <= 0 || cfg.jobs < 100 || cfg.cpus <= 0 || cfg.time_quantum <= 0) {
+        printf("[ERROR] Need --clients N[,N...] (up to 64 counts), --think Z >= 0, --burst S > 0, --jobs >= 100,\n"
+               "        a positive CPU count and a positive quantum.\n");
+        return 2;
+    }
+
+    Workload service;
+    workload_init(&service);
+    double mean_service = cfg.mean_burst;
+    if (service_path != NULL) {
+        if (!load_workload_file(service_path, &service)) return 1;
+        if (service.count == 0) {
+            printf("[ERROR] No processes to sample service times from.\n");
+            workload_free(&service);
+            return 1;
+        }
+        long long total = 0;
+        for (int i = 0; i < service.count; i++) total += service.procs[i].burst_time;
+        mean_service = (double)total / service.count;
+        cfg.service = &service;
+    }
+
+    ClosedLoopPoint* points = sim_malloc((size_t)count * sizeof(ClosedLoopPoint), MEM_METRICS);
+    if (points == NULL) {
+        printf("[ERROR] Failed to allocate memory for the closed-loop runs.\n");
+        workload_free(&service);
+        return 1;
+    }
+    for (int k = 0; k < count; k++) points[k].clients = counts[k];
+
+    double started = wall_seconds();
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < count; k++) closed_loop_evaluate(&cfg, &points[k]);
+
+    printf("\n--- CLOSED LOOP: %s on %d CPU(s), think %.2f, mean service %.2f, %d jobs per run ---\n",
+           policy_name(cfg.policy), cfg.cpus, cfg.think, mean_service, cfg.jobs);
+    printf("+---------+------------+------------+-------------+--------------+-------------+--------+-----------+-----------+-----------+\n");
+    printf("| Clients | Throughput | Bound      | Avg Waiting | Avg Turnarnd | p99 Turnarnd| Util   | In Flight | Oldest    | X*(R+Z)   |\n");
+    printf("+---------+------------+------------+-------------+--------------+-------------+--------+-----------+-----------+-----------+\n");
+    bool ok = true;
+    int flagged = 0;
+    for (int k = 0; k < count; k++) {
+        const ClosedLoopPoint* pt = &points[k];
+        if (!pt->ok) {
+            printf("[ERROR] Failed to allocate memory for the %d-client run.\n", pt->clients);
+            ok = false;
+            continue;
+        }
+        double bound = pt->clients / (mean_service + cfg.think);
+        if (bound > cfg.cpus / mean_service) bound = cfg.cpus / mean_service;
+        double little = pt->throughput * (pt->mean_turnaround + cfg.think);
+        bool broken = fabs(little - pt->clients) > CLOSED_LITTLE_TOLERANCE * pt->clients;
+        if (broken) flagged++;
+        printf("| %-7d | %-10.4f | %-10.4f | %-11.2f | %-12.2f | %-11d | %5.1f%% | %-9d | %-9d | %-8.2f%c |\n",
+               pt->clients, pt->throughput, bound, pt->mean_waiting, pt->mean_turnaround, pt->p99_turnaround,
+               pt->utilization * 100, pt->in_flight, pt->oldest_age, little, broken ? '!' : ' ');
+    }
+    printf("+---------+------------+------------+-------------+--------------+-------------+--------+-----------+-----------+-----------+\n");
+    printf("| Jobs still in flight at the horizon count with their age so far, so turnaround figures are lower bounds.\n");
+    if (flagged > 0) {
+        printf("[WARN] %d run(s) marked '!' break Little's law (X*(R+Z) more than %.0f%% away from N): jobs are starving\n"
+               "       past the horizon and latency is understated. Use more --jobs or a policy without starvation.\n",
+               flagged, CLOSED_LITTLE_TOLERANCE * 100);
+    }
+    printf("[ANALYSIS] Saturation point N* = C * (D + Z) / D = %.1f clients; beyond it throughput stays near %.4f\n"
+           "           and turnaround grows linearly with N. (%.3f seconds)\n",
+           cfg.cpus * (mean_service + cfg.think) / mean_service, cfg.cpus / mean_service, wall_seconds() - started);
+
+    sim_free(points);
+    workload_free(&service);
+    return ok ? 0 : 1;
+}
+
+// --- Partitioned Multi-CPU Simulation (Time Warp) ---
+// Har CPU ki apni ready queue hai. Ek dispatcher har arrival ko us CPU par bhejta hai jiske paas (dispatcher
+// ki jaankari mein) sabse kam bache hue jobs hain (join-shortest-queue, tie par chhota CPU), aur CPU har
+// completion par dispatcher ko DONE message bhejta hai. Model logical processes (LPs) mein bata hai: LP 0
+// dispatcher, LP 1..K CPUs. Dono taraf ke messages zero delay ke hain, isliye conservative synchronization
+// ko koi lookahead nahi milta; yahan optimistic (Time Warp) engine chalta hai:
+//  - Har LP apne pending events (time, kind, tie) order mein bina ruke process karta hai.
+//  - State saving incremental hai: LP ki har state write tw_set se hoti hai, jo purani value undo log mein
+//    rakhta hai. State sirf LP ke apne arrays mein hai, isliye rollback doosre LPs ko nahi chhoota.
+//  - Purane timestamp ka message (straggler) aane par baad ke events rollback hote hain: undo log ulta
+//    chalta hai aur un events ke bheje messages ke liye anti-messages jaate hain (lazy, neeche dekhein).
+//  - Har gvt_interval events ke baad (ya jab koi LP window ke andar aage na badh sake) workers barrier par
+//    milte hain, in-flight messages deliver hote hain aur GVT (sabse chhota unprocessed timestamp) nikalta
+//    hai. GVT se pehle ke events kabhi rollback nahi ho sakte, isliye woh commit hote hain aur unke
+//    undo/sent logs free (fossil collection).
+//  - Koi LP GVT + window se aage nahi jaata. Bina hadd ke dispatcher bahut aage ke arrivals purane
+//    outstanding counts par route kar deta hai aur lagbhag saara kaam rollback hota hai.
+// Same time par kind order ARRIVAL < JOB < SLICE_END < DONE < DISPATCH hai, aur har message apne bhejne
+// wale event se bada hai, isliye sequential order well-defined hai. Dispatcher ko time t ke completions
+// time t ke arrivals route karne ke baad dikhte hain. DISPATCH us instant ke saare events ke baad ek hi
+// scheduling decision leta hai, isliye har CPU apne processes par SimEngine ke bilkul barabar chalta hai.
+// "--engine sequential" wahi handlers ek worker par global order mein, bina state saving ke chalata hai.
+
+#define TW_KIND_ARRIVAL 0     // Dispatcher: arrival order ka agla process
+#define TW_KIND_JOB 1         // CPU: dispatcher ne process bheja
+#define TW_KIND_SLICE_END 2   // CPU: running process ka slice (ya burst) khatam
+#define TW_KIND_DONE 3        // Dispatcher: kisi CPU par ek process poora hua
+#define TW_KIND_DISPATCH 4    // CPU: is instant ke baaki events ke baad scheduling decision
+
+#define TW_DEFAULT_GVT_INTERVAL 1024
+
+// CPU LP ke scalar state variables (vars[] mein; dispatcher ke vars[] har CPU ke outstanding jobs hain).
+enum { TW_VAR_RUNNING, TW_VAR_SLICE_END, TW_VAR_RUN_START, TW_VAR_DISPATCH_AT,
+       TW_VAR_QUEUE_HEAD, TW_VAR_QUEUE_TAIL, TW_VAR_QUEUE_COUNT, TW_VAR_JOB_COUNT, TW_VAR_COUNT };
+// CPU ki job table mein ek job ke fields. FCFS/RR queue TW_JOB_NEXT se linked list hai.
+enum { TW_JOB_INDEX, TW_JOB_REMAINING, TW_JOB_RESPONSE, TW_JOB_COMPLETION, TW_JOB_NEXT, TW_JOB_FIELDS };
+enum { TW_EVENT_PENDING, TW_EVENT_PROCESSED, TW_EVENT_CANCELLED };
+
+typedef struct TwEvent {
+    int time;
+    int kind;
+    int tie;                  // Same time aur kind par order: process index, job slot ya CPU
+    int payload;              // ARRIVAL: arrival order position, JOB: process index, SLICE_END: slot, DONE: CPU
+    int dest;                 // Receiving LP
+    int state;                // Sirf receiving LP badalta hai
+    size_t undo_mark;         // Processing shuru hone par undo log ki absolute length
+    size_t sent_mark;         // Processing shuru hone par sent log ki absolute length
+    struct TwEvent* next_free;
+} TwEvent;
+
+// Undo entry array pointer ke zariye likhi jaati hai, taaki job table realloc hone par bhi sahi rahe.
+typedef struct {
+    int** array;
+    int index;
+    int old_value;
+} TwUndo;
+
+typedef struct {
+    TwEvent* event;
+    bool anti;
+} TwMessage;
+
+// Lazy cancellation: rollback hue event ke bheje messages turant cancel nahi hote. Event dobara chalne par
+// wahi message phir banta hai toh purana hi rehta hai (receiver ka rollback bachta hai); warna processing
+// sender ki key se aage badhte hi anti-message jaata hai.
+typedef struct {
+    TwEvent* event;
+    int time, kind, tie;      // Bhejne wale event ki key
+} TwLazy;
+
+#ifndef _WIN32
+typedef pthread_mutex_t TwLock;
+#define tw_lock_init(l) pthread_mutex_init((l), NULL)
+#define tw_lock_destroy(l) pthread_mutex_destroy(l)
+#define tw_lock(l) pthread_mutex_lock(l)
+#define tw_unlock(l) pthread_mutex_unlock(l)
+#else
+typedef int TwLock;           // Windows par sirf ek worker chalta hai
+#define tw_lock_init(l) ((void)(l))
+#define tw_lock_destroy(l) ((void)(l))
+#define tw_lock(l) ((void)(l))
+#define tw_unlock(l) ((void)(l))
+#endif
+
+typedef struct {
+    int id;
+    int* vars;
+    int* jobs;                // CPU: TW_JOB_FIELDS ints per job slot
+    int* heap;                // CPU (SJF/Priority): job slots ka min-heap
+    int job_capacity;
+
+    TwEvent** pending;        // Min-heap; cancelled events top par aane par hat-te hain
+    size_t pending_count, pending_capacity;
+    TwEvent** processed;      // Key order mein, abhi commit nahi hue
+    size_t processed_count, processed_capacity;
+    TwUndo* undo;             // Marks absolute hain: physical index = mark - undo_dropped
+    size_t undo_count, undo_capacity, undo_dropped;
+    TwEvent** sent;
+    size_t sent_count, sent_capacity, sent_dropped;
+    TwLazy* lazy;             // Stack: top par sabse chhoti sender key
+    size_t lazy_count, lazy_capacity;
+    const TwEvent* executing; // Abhi chal raha event (lazy match ke liye)
+
+    TwLock inbox_lock;
+    TwMessage* inbox;         // Doosre LPs ke messages (lock ke andar)
+    size_t inbox_count, inbox_capacity;
+    TwMessage* draining;      // Inbox se swap hokar yahan process hote hain
+    size_t draining_capacity;
+
+    TwEvent* free_events;
+    bool failed;
+    long long events_processed, events_rolled_back, rollbacks, anti_messages;
+} TwLp;
+
+typedef struct {
+#ifndef _WIN32
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+    int parties, waiting;
+    unsigned generation;
+    bool started;             // Saare worker threads ban jaane ke baad true
+} TwBarrier;
+
+typedef struct {
+    const Process* procs;
+    const int* order;         // Stable arrival order
+    int n;
+    Policy policy;
+    int time_quantum;
+    int cpus;
+    bool optimistic;
+    int workers;
+    int gvt_interval;
+    long long window;         // Optimism ki hadd: sirf GVT + window se pehle ke events (0 = koi hadd nahi)
+    TwLp* lps;                // lps[0] dispatcher, lps[1..cpus] CPUs
+    int lp_count;
+    TwBarrier barrier;
+    long long* worker_min;
+    bool* worker_failed;
+    long long gvt;
+    bool quiet, failed;
+    long long gvt_rounds;
+} TwContext;
+
+typedef struct {
+    long long events, rolled_back, rollbacks, anti_messages, gvt_rounds;
+    int workers;
+    double seconds;
+} TwStats;
+
+static void tw_barrier_wait(TwBarrier* b) {
+    if (b->parties == 1) return;
+#ifndef _WIN32
+    pthread_mutex_lock(&b->lock);
+    unsigned generation = b->generation;
+    if (++b->waiting == b->parties) {
+        b->waiting = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->cond);
+    } else {
+        while (generation == b->generation) pthread_cond_wait(&b->cond, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+#endif
+}
+
+// Array ko kam se kam 'needed' items tak badhata hai. Memory na mile toh NULL (purana array valid rehta hai).
+static void* tw_grow(void* items, size_t* capacity, size_t needed, size_t item_size) {
+    if (needed <= *capacity) return items;
+    size_t grown = (*capacity > 0) ? *capacity * 2 : 64;
+    while (grown < needed) grown *= 2;
+    void* p = sim_realloc(items, grown * item_size, MEM_QUEUES);
+    if (p != NULL) *capacity = grown;
+    return p;
+}
+
+static bool tw_event_less(const TwEvent* a, const TwEvent* b) {
+    if (a->time != b->time) return a->time < b->time;
+    if (a->kind != b->kind) return a->kind < b->kind;
+    return a->tie < b->tie;
+}
+
+static void tw_pending_push(TwLp* lp, TwEvent* ev) {
+    TwEvent** grown = tw_grow(lp->pending, &lp->pending_capacity, lp->pending_count + 1, sizeof(TwEvent*));
+    if (grown == NULL) { lp->failed = true; return; }
+    lp->pending = grown;
+    size_t i = lp->pending_count++;
+    while (i > 0 && tw_event_less(ev, lp->pending[(i - 1) / 2])) {
+        lp->pending[i] = lp->pending[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    lp->pending[i] = ev;
+}
+
+static TwEvent* tw_pending_pop(TwLp* lp) {
+    TwEvent* top = lp->pending[0];
+    TwEvent* last = lp->pending[--lp->pending_count];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= lp->pending_count) break;
+        if (child + 1 < lp->pending_count && tw_event_less(lp->pending[child + 1], lp->pending[child])) child++;
+        if (!tw_event_less(lp->pending[child], last)) break;
+        lp->pending[i] = lp->pending[child];
+        i = child;
+    }
+    if (lp->pending_count > 0) lp->pending[i] = last;
+    return top;
+}
+
+static TwEvent* tw_event_alloc(TwLp* lp) {
+    TwEvent* ev = lp->free_events;
+    if (ev != NULL) {
+        lp->free_events = ev->next_free;
+        return ev;
+    }
+    ev = sim_malloc(sizeof(TwEvent), MEM_QUEUES);
+    if (ev == NULL) lp->failed = true;
+    return ev;
+}
+
+static void tw_event_free(TwLp* lp, TwEvent* ev) {
+    ev->next_free = lp->free_events;
+    lp->free_events = ev;
+}
+
+// LP ka agla (cancel na hua) event, ya NULL.
+static TwEvent* tw_peek(TwLp* lp) {
+    while (lp->pending_count > 0 && lp->pending[0]->state == TW_EVENT_CANCELLED) tw_event_free(lp, tw_pending_pop(lp));
+    return (lp->pending_count > 0) ? lp->pending[0] : NULL;
+}
+
+// LP state ki har write yahin se: optimistic run mein purani value undo log mein jaati hai.
+static void tw_set(const TwContext* ctx, TwLp* lp, int** array, int index, int value) {
+    if (ctx->optimistic) {
+        TwUndo* grown = tw_grow(lp->undo, &lp->undo_capacity, lp->undo_count + 1, sizeof(TwUndo));
+        if (grown == NULL) {
+            lp->failed = true;
+        } else {
+            lp->undo = grown;
+            lp->undo[lp->undo_count++] = (TwUndo){ array, index, (*array)[index] };
+        }
+    }
+    (*array)[index] = value;
+}
+
+static void tw_set_var(const TwContext* ctx, TwLp* lp, int var, int value) {
+    tw_set(ctx, lp, &lp->vars, var, value);
+}
+
+static int tw_job(const TwLp* lp, int slot, int field) {
+    return lp->jobs[slot * TW_JOB_FIELDS + field];
+}
+
+static void tw_set_job(const TwContext* ctx, TwLp* lp, int slot, int field, int value) {
+    tw_set(ctx, lp, &lp->jobs, slot * TW_JOB_FIELDS + field, value);
+}
+
+static void tw_post(TwLp* from, TwLp* to, TwEvent* ev, bool anti) {
+    tw_lock(&to->inbox_lock);
+    TwMessage* grown = tw_grow(to->inbox, &to->inbox_capacity, to->inbox_count + 1, sizeof(TwMessage));
+    if (grown == NULL) {
+        from->failed = true;
+    } else {
+        to->inbox = grown;
+        to->inbox[to->inbox_count++] = (TwMessage){ ev, anti };
+    }
+    tw_unlock(&to->inbox_lock);
+}
+
+static void tw_send(const TwContext* ctx, TwLp* from, int dest, int time, int kind, int tie, int payload) {
+    TwEvent* ev = NULL;
+    if (ctx->optimistic) {
+        TwEvent** grown = tw_grow(from->sent, &from->sent_capacity, from->sent_count + 1, sizeof(TwEvent*));
+        if (grown == NULL) { from->failed = true; return; }
+        from->sent = grown;
+        // Isi event ke pichhle execution ne bilkul yahi message bheja tha? Toh wahi rakho.
+        const TwEvent* cur = from->executing;
+        for (size_t i = from->lazy_count; i-- > 0; ) {
+            const TwLazy* l = &from->lazy[i];
+            if (l->time != cur->time || l->kind != cur->kind || l->tie != cur->tie) break;
+            TwEvent* old = l->event;
+            if (old->dest == dest && old->time == time && old->kind == kind && old->tie == tie && old->payload == payload) {
+                memmove(&from->lazy[i], &from->lazy[i + 1], (from->lazy_count - i - 1) * sizeof(TwLazy));
+                from->lazy_count--;
+                from->sent[from->sent_count++] = old;
+                return;
+            }
+        }
+        ev = tw_event_alloc(from);
+        if (ev == NULL) return;
+        from->sent[from->sent_count++] = ev;
+    } else {
+        ev = tw_event_alloc(from);
+        if (ev == NULL) return;
+    }
+    *ev = (TwEvent){ .time = time, .kind = kind, .tie = tie, .payload = payload, .dest = dest, .state = TW_EVENT_PENDING };
+    TwLp* to = &ctx->lps[dest];
+    // Apne aap ko (aur sequential run mein sabko) bheja event kabhi straggler nahi hota.
+    if (!ctx->optimistic || to == from) tw_pending_push(to, ev);
+    else tw_post(from, to, ev, false);
+}
+
+// Bheja hua message cancel: apna event seedha, doosre LP ko anti-message.
+static void tw_cancel_sent(const TwContext* ctx, TwLp* lp, TwEvent* s) {
+    TwLp* to = &ctx->lps[s->dest];
+    if (to == lp) {
+        // Apna bheja event sender se bada hai, isliye abhi pending hi hai.
+        s->state = TW_EVENT_CANCELLED;
+    } else {
+        tw_post(lp, to, s, true);
+        lp->anti_messages++;
+    }
+}
+
+// Jin lazy messages ke sender ki key 'next' se pehle hai (inclusive ho toh barabar bhi; NULL matlab sab),
+// unka event dobara chal chuka ya cancel ho chuka, isliye ab woh sach mein cancel hote hain.
+static void tw_flush_lazy(const TwContext* ctx, TwLp* lp, const TwEvent* next, bool inclusive) {
+    while (lp->lazy_count > 0) {
+        const TwLazy* l = &lp->lazy[lp->lazy_count - 1];
+        if (next != NULL) {
+            TwEvent key = { .time = l->time, .kind = l->kind, .tie = l->tie };
+            if (!(tw_event_less(&key, next) || (inclusive && !tw_event_less(next, &key)))) break;
+        }
+        lp->lazy_count--;
+        tw_cancel_sent(ctx, lp, l->event);
+    }
+}
+
+// 'bound' se baad ke processed events (inclusive ho toh 'bound' samet) undo karke wapas pending mein
+// daalta hai. Unke bheje messages lazy stack par jaate hain.
+static void tw_rollback(const TwContext* ctx, TwLp* lp, const TwEvent* bound, bool inclusive) {
+    lp->rollbacks++;
+    while (lp->processed_count > 0) {
+        TwEvent* ev = lp->processed[lp->processed_count - 1];
+        if (inclusive ? tw_event_less(ev, bound) : !tw_event_less(bound, ev)) break;
+        lp->processed_count--;
+
+        size_t undo_mark = ev->undo_mark - lp->undo_dropped;
+        while (lp->undo_count > undo_mark) {
+            const TwUndo* u = &lp->undo[--lp->undo_count];
+            (*u->array)[u->index] = u->old_value;
+        }
+        size_t sent_mark = ev->sent_mark - lp->sent_dropped;
+        TwLazy* grown = (lp->sent_count == sent_mark) ? lp->lazy :
+                        tw_grow(lp->lazy, &lp->lazy_capacity, lp->lazy_count + (lp->sent_count - sent_mark), sizeof(TwLazy));
+        if (lp->sent_count > sent_mark && grown == NULL) {
+            lp->failed = true;
+            while (lp->sent_count > sent_mark) tw_cancel_sent(ctx, lp, lp->sent[--lp->sent_count]);
+        } else {
+            lp->lazy = grown;
+            while (lp->sent_count > sent_mark) {
+                lp->lazy[lp->lazy_count++] = (TwLazy){ lp->sent[--lp->sent_count], ev->time, ev->kind, ev->tie };
+            }
+        }
+        ev->state = TW_EVENT_PENDING;
+        tw_pending_push(lp, ev);
+        lp->events_rolled_back++;
+    }
+}
+
+static void tw_receive(const TwContext* ctx, TwLp* lp, TwEvent* ev, bool anti) {
+    if (!anti) {
+        if (lp->processed_count > 0 && tw_event_less(ev, lp->processed[lp->processed_count - 1])) {
+            tw_rollback(ctx, lp, ev, false);
+        }
+        tw_pending_push(lp, ev);
+        return;
+    }
+    // Anti-message: positive message hamesha pehle aata hai (har sender se inbox FIFO hai).
+    if (ev->state == TW_EVENT_PROCESSED) tw_rollback(ctx, lp, ev, true);
+    ev->state = TW_EVENT_CANCELLED;
+}
+
+static void tw_drain(const TwContext* ctx, TwLp* lp) {
+    tw_lock(&lp->inbox_lock);
+    TwMessage* messages = lp->inbox;
+    size_t count = lp->inbox_count, capacity = lp->inbox_capacity;
+    lp->inbox = lp->draining;
+    lp->inbox_capacity = lp->draining_capacity;
+    lp->inbox_count = 0;
+    tw_unlock(&lp->inbox_lock);
+
+    for (size_t i = 0; i < count; i++) tw_receive(ctx, lp, messages[i].event, messages[i].anti);
+    lp->draining = messages;
+    lp->draining_capacity = capacity;
+}
+
+// --- CPU LP ---
+
+static bool tw_preemptive(const TwContext* ctx) {
+    return ctx->policy == POLICY_SJF || ctx->policy == POLICY_PRIORITY;
+}
+
+// Ready heap ordering, engine_less jaisa: SJF remaining time, Priority priority, tie par process index.
+static bool tw_job_less(const TwContext* ctx, const TwLp* lp, int a, int b) {
+    int ia = tw_job(lp, a, TW_JOB_INDEX), ib = tw_job(lp, b, TW_JOB_INDEX);
+    int ka, kb;
+    if (ctx->policy == POLICY_SJF) {
+        ka = tw_job(lp, a, TW_JOB_REMAINING);
+        kb = tw_job(lp, b, TW_JOB_REMAINING);
+    } else {
+        ka = ctx->procs[ia].priority;
+        kb = ctx->procs[ib].priority;
+    }
+    if (ka != kb) return ka < kb;
+    return ia < ib;
+}
+
+static void tw_queue_push(const TwContext* ctx, TwLp* lp, int slot) {
+    int count = lp->vars[TW_VAR_QUEUE_COUNT];
+    tw_set_var(ctx, lp, TW_VAR_QUEUE_COUNT, count + 1);
+    if (tw_preemptive(ctx)) {
+        int i = count;
+        while (i > 0 && tw_job_less(ctx, lp, slot, lp->heap[(i - 1) / 2])) {
+            tw_set(ctx, lp, &lp->heap, i, lp->heap[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+        tw_set(ctx, lp, &lp->heap, i, slot);
+        return;
+    }
+    tw_set_job(ctx, lp, slot, TW_JOB_NEXT, -1);
+    if (count == 0) tw_set_var(ctx, lp, TW_VAR_QUEUE_HEAD, slot);
+    else tw_set_job(ctx, lp, lp->vars[TW_VAR_QUEUE_TAIL], TW_JOB_NEXT, slot);
+    tw_set_var(ctx, lp, TW_VAR_QUEUE_TAIL, slot);
+}
+
+static int tw_queue_pop(const TwContext* ctx, TwLp* lp) {
+    int count = lp->vars[TW_VAR_QUEUE_COUNT] - 1;
+    tw_set_var(ctx, lp, TW_VAR_QUEUE_COUNT, count);
+    if (!tw_preemptive(ctx)) {
+        int slot = lp->vars[TW_VAR_QUEUE_HEAD];
+        tw_set_var(ctx, lp, TW_VAR_QUEUE_HEAD, tw_job(lp, slot, TW_JOB_NEXT));
+        return slot;
+    }
+    int top = lp->heap[0];
+    if (count == 0) return top;
+    int last = lp->heap[count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= count) break;
+        if (child + 1 < count && tw_job_less(ctx, lp, lp->heap[child + 1], lp->heap[child])) child++;
+        if (!tw_job_less(ctx, lp, lp->heap[child], last)) break;
+        tw_set(ctx, lp, &lp->heap, i, lp->heap[child]);
+        i = child;
+    }
+    tw_set(ctx, lp, &lp->heap, i, last);
+    return top;
+}
+
+static void tw_schedule_dispatch(const TwContext* ctx, TwLp* lp, int time) {
+    if (lp->vars[TW_VAR_DISPATCH_AT] == time) return;
+    tw_set_var(ctx, lp, TW_VAR_DISPATCH_AT, time);
+    tw_send(ctx, lp, lp->id, time, TW_KIND_DISPATCH, 0, 0);
+}
+
+static void tw_cpu_job(const TwContext* ctx, TwLp* lp, const TwEvent* ev) {
+    int slot = lp->vars[TW_VAR_JOB_COUNT];
+    if (slot == lp->job_capacity) {
+        size_t jobs_capacity = (size_t)lp->job_capacity * TW_JOB_FIELDS;
+        size_t heap_capacity = (size_t)lp->job_capacity;
+        int* jobs = tw_grow(lp->jobs, &jobs_capacity, (size_t)(slot + 1) * TW_JOB_FIELDS, sizeof(int));
+        if (jobs != NULL) lp->jobs = jobs;
+        int* heap = tw_grow(lp->heap, &heap_capacity, jobs_capacity / TW_JOB_FIELDS, sizeof(int));
+        if (jobs == NULL || heap == NULL) { lp->failed = true; return; }
+        lp->heap = heap;
+        lp->job_capacity = (int)(jobs_capacity / TW_JOB_FIELDS);
+    }
+    // JOB_COUNT se aage ke slots dead state hain, isliye naye slot ki initialization log nahi hoti.
+    int* job = &lp->jobs[slot * TW_JOB_FIELDS];
+    job[TW_JOB_INDEX] = ev->payload;
+    job[TW_JOB_REMAINING] = ctx->procs[ev->payload].burst_time;
+    job[TW_JOB_RESPONSE] = 0;
+    job[TW_JOB_COMPLETION] = 0;
+    tw_set_var(ctx, lp, TW_VAR_JOB_COUNT, slot + 1);
+    tw_queue_push(ctx, lp, slot);
+    if (lp->vars[TW_VAR_RUNNING] == -1 || tw_preemptive(ctx)) tw_schedule_dispatch(ctx, lp, ev->time);
+}
+
+static void tw_cpu_slice_end(const TwContext* ctx, TwLp* lp, const TwEvent* ev) {
+    int slot = ev->payload;
+    if (lp->vars[TW_VAR_RUNNING] != slot || lp->vars[TW_VAR_SLICE_END] != ev->time) return; // Preempt ho chuka
+    int remaining = tw_job(lp, slot, TW_JOB_REMAINING) - (ev->time - lp->vars[TW_VAR_RUN_START]);
+    tw_set_job(ctx, lp, slot, TW_JOB_REMAINING, remaining);
+    tw_set_var(ctx, lp, TW_VAR_RUNNING, -1);
+    if (remaining == 0) {
+        tw_set_job(ctx, lp, slot, TW_JOB_COMPLETION, ev->time);
+        tw_send(ctx, lp, 0, ev->time, TW_KIND_DONE, lp->id - 1, lp->id - 1);
+    } else {
+        tw_queue_push(ctx, lp, slot); // Sirf RR: is instant ke arrivals pehle hi queue mein hain
+    }
+    if (lp->vars[TW_VAR_QUEUE_COUNT] > 0) tw_schedule_dispatch(ctx, lp, ev->time);
+}
+
+static void tw_cpu_dispatch(const TwContext* ctx, TwLp* lp, const TwEvent* ev) {
+    int now = ev->time;
+    tw_set_var(ctx, lp, TW_VAR_DISPATCH_AT, -1);
+    if (lp->vars[TW_VAR_QUEUE_COUNT] == 0) return;
+
+    int running = lp->vars[TW_VAR_RUNNING];
+    if (running != -1) {
+        if (!tw_preemptive(ctx)) return;
+        // Preemption check, multi_ready_beats jaisa: running process ki key abhi ka remaining time hai.
+        int top = lp->heap[0];
+        int running_remaining = lp->vars[TW_VAR_SLICE_END] - now;
+        int top_index = tw_job(lp, top, TW_JOB_INDEX), running_index = tw_job(lp, running, TW_JOB_INDEX);
+        int top_key, running_key;
+        if (ctx->policy == POLICY_SJF) {
+            top_key = tw_job(lp, top, TW_JOB_REMAINING);
+            running_key = running_remaining;
+        } else {
+            top_key = ctx->procs[top_index].priority;
+            running_key = ctx->procs[running_index].priority;
+        }
+        if (top_key > running_key || (top_key == running_key && top_index > running_index)) return;
+        tw_set_job(ctx, lp, running, TW_JOB_REMAINING, running_remaining);
+        tw_set_var(ctx, lp, TW_VAR_RUNNING, -1);
+        tw_queue_push(ctx, lp, running);
+    }
+
+    int slot = tw_queue_pop(ctx, lp);
+    const Process* p = &ctx->procs[tw_job(lp, slot, TW_JOB_INDEX)];
+    int remaining = tw_job(lp, slot, TW_JOB_REMAINING);
+    if (remaining == p->burst_time) tw_set_job(ctx, lp, slot, TW_JOB_RESPONSE, now - p->arrival_time);
+    int slice = remaining;
+    if (ctx->policy == POLICY_RR && ctx->time_quantum < slice) slice = ctx->time_quantum;
+    tw_set_var(ctx, lp, TW_VAR_RUNNING, slot);
+    tw_set_var(ctx, lp, TW_VAR_RUN_START, now);
+    tw_set_var(ctx, lp, TW_VAR_SLICE_END, now + slice);
+    tw_send(ctx, lp, lp->id, now + slice, TW_KIND_SLICE_END, slot, slot);
+}
+
+// --- Dispatcher LP ---
+
+static void tw_dispatcher_event(const TwContext* ctx, TwLp* lp, const TwEvent* ev) {
+    if (ev->kind == TW_KIND_DONE) {
+        tw_set_var(ctx, lp, ev->payload, lp->vars[ev->payload] - 1);
+        return;
+    }
+    int idx = ctx->order[ev->payload];
+    int target = 0;
+    for (int c = 1; c < ctx->cpus; c++) {
+        if (lp->vars[c] < lp->vars[target]) target = c;
+    }
+    tw_set_var(ctx, lp, target, lp->vars[target] + 1);
+    tw_send(ctx, lp, 1 + target, ev->time, TW_KIND_JOB, idx, idx);
+    if (ev->payload + 1 < ctx->n) {
+        int next = ctx->order[ev->payload + 1];
+        tw_send(ctx, lp, 0, ctx->procs[next].arrival_time, TW_KIND_ARRIVAL, next, ev->payload + 1);
+    }
+}
+
+static void tw_execute(TwContext* ctx, TwLp* lp) {
+    TwEvent* ev = tw_pending_pop(lp);
+    ev->undo_mark = lp->undo_dropped + lp->undo_count;
+    ev->sent_mark = lp->sent_dropped + lp->sent_count;
+    if (ctx->optimistic) tw_flush_lazy(ctx, lp, ev, false);
+    lp->executing = ev;
+    switch (ev->kind) {
+        case TW_KIND_JOB: tw_cpu_job(ctx, lp, ev); break;
+        case TW_KIND_SLICE_END: tw_cpu_slice_end(ctx, lp, ev); break;
+        case TW_KIND_DISPATCH: tw_cpu_dispatch(ctx, lp, ev); break;
+        default: tw_dispatcher_event(ctx, lp, ev); break;
+    }
+    lp->executing = NULL;
+    lp->events_processed++;
+    if (!ctx->optimistic) {
+        tw_event_free(lp, ev);
+        return;
+    }
+    tw_flush_lazy(ctx, lp, ev, true);
+    TwEvent** grown = tw_grow(lp->processed, &lp->processed_capacity, lp->processed_count + 1, sizeof(TwEvent*));
+    if (grown == NULL) { lp->failed = true; return; }
+    lp->processed = grown;
+    ev->state = TW_EVENT_PROCESSED;
+    lp->processed[lp->processed_count++] = ev;
+}
+
+// GVT se pehle ke processed events commit karta hai: unke undo aur sent log entries ab kabhi kaam nahi aayengi.
+static void tw_fossil_collect(TwLp* lp, long long gvt) {
+    size_t committed = 0;
+    while (committed < lp->processed_count && lp->processed[committed]->time < gvt) committed++;
+    if (committed == 0) return;
+
+    bool all = (committed == lp->processed_count);
+    size_t undo_keep = all ? lp->undo_dropped + lp->undo_count : lp->processed[committed]->undo_mark;
+    size_t sent_keep = all ? lp->sent_dropped + lp->sent_count : lp->processed[committed]->sent_mark;
+    for (size_t i = 0; i < committed; i++) tw_event_free(lp, lp->processed[i]);
+    lp->processed_count -= committed;
+    memmove(lp->processed, lp->processed + committed, lp->processed_count * sizeof(TwEvent*));
+
+    size_t drop = undo_keep - lp->undo_dropped;
+    lp->undo_count -= drop;
+    memmove(lp->undo, lp->undo + drop, lp->undo_count * sizeof(TwUndo));
+    lp->undo_dropped = undo_keep;
+
+    drop = sent_keep - lp->sent_dropped;
+    lp->sent_count -= drop;
+    memmove(lp->sent, lp->sent + drop, lp->sent_count * sizeof(TwEvent*));
+    lp->sent_dropped = sent_keep;
+}
+
+// Ek worker: LPs worker, worker + workers, ... iska hai. Har round mein gvt_interval tak events
+// optimistically, phir barrier par quiescence, GVT aur fossil collection.
+static void tw_worker(TwContext* ctx, int worker) {
+    for (;;) {
+        long long horizon = (ctx->window > 0) ? ctx->gvt + ctx->window : LLONG_MAX;
+        for (int step = 0; step < ctx->gvt_interval; step++) {
+            TwLp* best = NULL;
+            TwEvent* best_event = NULL;
+            for (int i = worker; i < ctx->lp_count; i += ctx->workers) {
+                TwLp* lp = &ctx->lps[i];
+                if (ctx->optimistic) tw_drain(ctx, lp);
+                TwEvent* ev = tw_peek(lp);
+                if (ev != NULL && (best_event == NULL || tw_event_less(ev, best_event))) {
+                    best = lp;
+                    best_event = ev;
+                }
+            }
+            if (best == NULL || best_event->time >= horizon) break;
+            tw_execute(ctx, best);
+        }
+
+        // Quiescence: jab tak kisi inbox mein message hai, deliver karte raho (rollbacks naye anti-messages bhej sakte hain).
+        tw_barrier_wait(&ctx->barrier);
+        for (;;) {
+            for (int i = worker; i < ctx->lp_count; i += ctx->workers) {
+                TwLp* lp = &ctx->lps[i];
+                tw_drain(ctx, lp);
+                if (ctx->optimistic) tw_flush_lazy(ctx, lp, tw_peek(lp), false);
+            }
+            tw_barrier_wait(&ctx->barrier);
+            if (worker == 0) {
+                bool quiet = true;
+                for (int i = 0; i < ctx->lp_count && quiet; i++) {
+                    tw_lock(&ctx->lps[i].inbox_lock);
+                    quiet = (ctx->lps[i].inbox_count == 0);
+                    tw_unlock(&ctx->lps[i].inbox_lock);
+                }
+                ctx->quiet = quiet;
+            }
+            tw_barrier_wait(&ctx->barrier);
+            if (ctx->quiet) break;
+        }
+
+        // Koi message raaste mein nahi hai, isliye GVT sabse chhota pending timestamp hai.
+        long long local = LLONG_MAX;
+        bool failed = false;
+        for (int i = worker; i < ctx->lp_count; i += ctx->workers) {
+            const TwLp* lp = &ctx->lps[i];
+            TwEvent* ev = tw_peek(&ctx->lps[i]);
+            if (ev != NULL && ev->time < local) local = ev->time;
+            // Lazy message ka anti baad mein ja sakta hai, isliye uske sender ka time bhi GVT ko rokta hai.
+            if (lp->lazy_count > 0 && lp->lazy[lp->lazy_count - 1].time < local) local = lp->lazy[lp->lazy_count - 1].time;
+            failed = failed || lp->failed;
+        }
+        ctx->worker_min[worker] = local;
+        ctx->worker_failed[worker] = failed;
+        tw_barrier_wait(&ctx->barrier);
+        if (worker == 0) {
+            long long gvt = LLONG_MAX;
+            bool any_failed = false;
+            for (int w = 0; w < ctx->workers; w++) {
+                if (ctx->worker_min[w] < gvt) gvt = ctx->worker_min[w];
+                any_failed = any_failed || ctx->worker_failed[w];
+            }
+            ctx->gvt = gvt;
+            ctx->failed = any_failed;
+            ctx->gvt_rounds++;
+        }
+        tw_barrier_wait(&ctx->barrier);
+        if (ctx->failed) return;
+        long long gvt = ctx->gvt;
+        for (int i = worker; i < ctx->lp_count; i += ctx->workers) tw_fossil_collect(&ctx->lps[i], gvt);
+        if (gvt == LLONG_MAX) return;
+    }
+}
+
+#ifndef _WIN32
+typedef struct {
+    TwContext* ctx;
+    int worker;
+} TwWorkerArg;
+
+static void* tw_worker_thread(void* arg) {
+    TwWorkerArg* a = arg;
+    TwBarrier* b = &a->ctx->barrier;
+    pthread_mutex_lock(&b->lock);
+    while (!b->started) pthread_cond_wait(&b->cond, &b->lock);
+    pthread_mutex_unlock(&b->lock);
+    if (a->worker < a->ctx->workers) tw_worker(a->ctx, a->worker);
+    return NULL;
+}
+#endif
+
+// Workers chalata hai (calling thread worker 0 banta hai). Thread na ban paaye toh kam workers se chalta hai.
+static void tw_run_workers(TwContext* ctx) {
+#ifndef _WIN32
+    int requested = ctx->workers;
+    pthread_t* threads = sim_malloc((size_t)requested * sizeof(pthread_t), MEM_QUEUES);
+    TwWorkerArg* args = sim_malloc((size_t)requested * sizeof(TwWorkerArg), MEM_QUEUES);
+    int created = 0;
+    pthread_mutex_init(&ctx->barrier.lock, NULL);
+    pthread_cond_init(&ctx->barrier.cond, NULL);
+    ctx->barrier.started = false;
+    if (threads != NULL && args != NULL) {
+        for (int w = 1; w < requested; w++) {
+            args[created] = (TwWorkerArg){ ctx, w };
+            if (pthread_create(&threads[created], NULL, tw_worker_thread, &args[created]) != 0) break;
+            created++;
+        }
+    }
+    pthread_mutex_lock(&ctx->barrier.lock);
+    ctx->workers = created + 1;
+    ctx->barrier.parties = ctx->workers;
+    ctx->barrier.started = true;
+    pthread_cond_broadcast(&ctx->barrier.cond);
+    pthread_mutex_unlock(&ctx->barrier.lock);
+
+    tw_worker(ctx, 0);
+    for (int i = 0; i < created; i++) pthread_join(threads[i], NULL);
+    pthread_cond_destroy(&ctx->barrier.cond);
+    pthread_mutex_destroy(&ctx->barrier.lock);
+    sim_free(threads);
+    sim_free(args);
+#else
+    ctx->workers = 1;
+    ctx->barrier.parties = 1;
+    tw_worker(ctx, 0);
+#endif
+}
+
+static void tw_free_lp(TwLp* lp) {
+    for (size_t i = 0; i < lp->pending_count; i++) sim_free(lp->pending[i]);
+    for (size_t i = 0; i < lp->processed_count; i++) sim_free(lp->processed[i]);
+    for (size_t i = 0; i < lp->inbox_count; i++) {
+        if (!lp->inbox[i].anti) sim_free(lp->inbox[i].event);
+    }
+    while (lp->free_events != NULL) {
+        TwEvent* next = lp->free_events->next_free;
+        sim_free(lp->free_events);
+        lp->free_events = next;
+    }
+    sim_free(lp->vars);
+    sim_free(lp->jobs);
+    sim_free(lp->heap);
+    sim_free(lp->pending);
+    sim_free(lp->processed);
+    sim_free(lp->undo);
+    sim_free(lp->sent);
+    sim_free(lp->lazy);
+    sim_free(lp->inbox);
+    sim_free(lp->draining);
+    tw_lock_destroy(&lp->inbox_lock);
+}
+
+// Partitioned model ko 'cpus' CPUs par chalata hai (optimistic: Time Warp, warna sequential). Har process
+// ke results 'out' mein (workload ki copy) aur uska CPU cpu_of mein aata hai. Memory na mile toh false.
+static bool partition_simulate(const Process workload[], int n, Policy policy, int time_quantum, int cpus, bool optimistic,
+                               int workers, int gvt_interval, long long window, Process out[], int cpu_of[], TwStats* stats) {
+    TwContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.procs = workload;
+    ctx.n = n;
+    ctx.policy = policy;
+    ctx.time_quantum = time_quantum;
+    ctx.cpus = cpus;
+    ctx.optimistic = optimistic;
+    ctx.lp_count = cpus + 1;
+    ctx.workers = optimistic ? (workers < ctx.lp_count ? workers : ctx.lp_count) : 1;
+    if (ctx.workers < 1) ctx.workers = 1;
+    ctx.gvt_interval = gvt_interval;
+    ctx.window = window;
+    ctx.barrier.parties = 1;
+
+    int* order = sim_malloc((size_t)(n > 0 ? n : 1) * sizeof(int), MEM_PROCESS_TABLE);
+    int* scratch = sim_malloc((size_t)(n > 0 ? n : 1) * sizeof(int), MEM_PROCESS_TABLE);
+    ctx.lps = sim_malloc((size_t)ctx.lp_count * sizeof(TwLp), MEM_QUEUES);
+    ctx.worker_min = sim_malloc((size_t)ctx.workers * sizeof(long long), MEM_QUEUES);
+    ctx.worker_failed = sim_malloc((size_t)ctx.workers * sizeof(bool), MEM_QUEUES);
+    bool ok = (order != NULL && scratch != NULL && ctx.lps != NULL && ctx.worker_min != NULL && ctx.worker_failed != NULL);
+    if (ctx.lps != NULL) {
+        memset(ctx.lps, 0, (size_t)ctx.lp_count * sizeof(TwLp));
+        for (int i = 0; i < ctx.lp_count; i++) {
+            TwLp* lp = &ctx.lps[i];
+            lp->id = i;
+            tw_lock_init(&lp->inbox_lock);
+            lp->vars = sim_malloc((size_t)(i == 0 ? cpus : TW_VAR_COUNT) * sizeof(int), MEM_QUEUES);
+            if (lp->vars == NULL) { ok = false; continue; }
+            if (i == 0) {
+                memset(lp->vars, 0, (size_t)cpus * sizeof(int));
+            } else {
+                memset(lp->vars, 0, TW_VAR_COUNT * sizeof(int));
+                lp->vars[TW_VAR_RUNNING] = -1;
+                lp->vars[TW_VAR_DISPATCH_AT] = -1;
+            }
+        }
+    }
+
+    double started = wall_seconds();
+    if (ok && n > 0) {
+        sort_by_arrival(workload, n, order, scratch);
+        ctx.order = order;
+        ctx.gvt = workload[order[0]].arrival_time;
+        TwEvent* first = tw_event_alloc(&ctx.lps[0]);
+        if (first == NULL) {
+            ok = false;
+        } else {
+            *first = (TwEvent){ .time = workload[order[0]].arrival_time, .kind = TW_KIND_ARRIVAL, .tie = order[0],
+                                .payload = 0, .dest = 0, .state = TW_EVENT_PENDING };
+            tw_pending_push(&ctx.lps[0], first);
+            tw_run_workers(&ctx);
+            ok = !ctx.failed;
+        }
+    }
+
+    if (ok) {
+        // Commit ho chuke state se results: har CPU ki job table.
+        memcpy(out, workload, (size_t)n * sizeof(Process));
+        for (int c = 0; c < cpus; c++) {
+            const TwLp* lp = &ctx.lps[1 + c];
+            for (int slot = 0; slot < lp->vars[TW_VAR_JOB_COUNT]; slot++) {
+                Process* p = &out[tw_job(lp, slot, TW_JOB_INDEX)];
+                p->remaining_time = tw_job(lp, slot, TW_JOB_REMAINING);
+                p->response_time = tw_job(lp, slot, TW_JOB_RESPONSE);
+                p->completion_time = tw_job(lp, slot, TW_JOB_COMPLETION);
+                p->is_completed = (p->remaining_time == 0);
+                p->turnaround_time = p->completion_time - p->arrival_time;
+                p->waiting_time = p->turnaround_time - p->burst_time;
+                cpu_of[p - out] = c;
+            }
+        }
+        memset(stats, 0, sizeof(*stats));
+        for (int i = 0; i < ctx.lp_count; i++) {
+            stats->events += ctx.lps[i].events_processed;
+            stats->rolled_back += ctx.lps[i].events_rolled_back;
+            stats->rollbacks += ctx.lps[i].rollbacks;
+            stats->anti_messages += ctx.lps[i].anti_messages;
+        }
+        stats->gvt_rounds = ctx.gvt_rounds;
+        stats->workers = ctx.workers;
+        stats->seconds = wall_seconds() - started;
+    }
+
+    if (ctx.lps != NULL) {
+        for (int i = 0; i < ctx.lp_count; i++) tw_free_lp(&ctx.lps[i]);
+    }
+    sim_free(ctx.lps);
+    sim_free(ctx.worker_min);
+    sim_free(ctx.worker_failed);
+    sim_free(order);
+    sim_free(scratch);
+    return ok;
+}
+
+typedef struct {
+    int time;
+    int cpu;
+} PartitionCompletion;
+
+static int compare_partition_completion(const void* a, const void* b) {
+    const PartitionCompletion* x = a;
+    const PartitionCompletion* y = b;
+    return (x->time > y->time) - (x->time < y->time);
+}
+
+// Partitioned results ko existing sequential engine se check karta hai: (1) completion times ke hisaab se har
+// arrival wahi CPU par gaya jo join-shortest-queue deta hai, aur (2) har CPU ke processes akele SimEngine par
+// chalane se wahi completion aur response times aate hain. Mismatch ya memory na milne par false.
+static bool partition_verify(const Process workload[], int n, Policy policy, int time_quantum, int cpus,
+                             const Process result[], const int cpu_of[]) {
+    int* order = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+    int* scratch = sim_malloc((size_t)n * sizeof(int), MEM_PROCESS_TABLE);
+    int* outstanding = sim_malloc((size_t)cpus * sizeof(int), MEM_METRICS);
+    PartitionCompletion* done = sim_malloc((size_t)n * sizeof(PartitionCompletion), MEM_METRICS);
+    Process* subset = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+    if (order == NULL || scratch == NULL || outstanding == NULL || done == NULL || subset == NULL) {
+        printf("[ERROR] Failed to allocate memory for verification.\n");
+        sim_free(order); sim_free(scratch); sim_free(outstanding); sim_free(done); sim_free(subset);
+        return false;
+    }
+
+    bool ok = true;
+    sort_by_arrival(workload, n, order, scratch);
+    for (int i = 0; i < n; i++) done[i] = (PartitionCompletion){ result[i].completion_time, cpu_of[i] };
+    qsort(done, n, sizeof(PartitionCompletion), compare_partition_completion);
+    memset(outstanding, 0, (size_t)cpus * sizeof(int));
+    for (int k = 0, j = 0; k < n && ok; k++) {
+        int idx = order[k];
+        int t = workload[idx].arrival_time;
+        // Time t ke completions dispatcher ko time t ke arrivals ke baad dikhte hain.
+        while (j < n && done[j].time < t) outstanding[done[j++].cpu]--;
+        int target = 0;
+        for (int c = 1; c < cpus; c++) {
+            if (outstanding[c] < outstanding[target]) target = c;
+        }
+        if (cpu_of[idx] != target) {
+            printf("[MISMATCH] PID %d was routed to CPU %d, join-shortest-queue gives CPU %d.\n",
+                   workload[idx].pid, cpu_of[idx], target);
+            ok = false;
+        }
+        outstanding[target]++;
+    }
+
+    for (int c = 0; c < cpus && ok; c++) {
+        int m = 0;
+        for (int i = 0; i < n; i++) {
+            if (cpu_of[i] == c) { subset[m] = workload[i]; scratch[m] = i; m++; }
+        }
+        if (m == 0) continue;
+        SimEngine engine;
+        if (!engine_init(&engine, policy, time_quantum, subset, m, false)) {
+            printf("[ERROR] Failed to allocate memory for verification.\n");
+            ok = false;
+            break;
+        }
+        engine_run(&engine);
+        for (int s = 0; s < m && ok; s++) {
+            const Process* r = &result[scratch[s]];
+            if (subset[s].completion_time != r->completion_time || subset[s].response_time != r->response_time) {
+                printf("[MISMATCH] PID %d on CPU %d: engine completion %d response %d, partitioned completion %d response %d.\n",
+                       r->pid, c, subset[s].completion_time, subset[s].response_time, r->completion_time, r->response_time);
+                ok = false;
+            }
+        }
+        engine_free(&engine);
+    }
+
+    sim_free(order);
+    sim_free(scratch);
+    sim_free(outstanding);
+    sim_free(done);
+    sim_free(subset);
+    return ok;
+}
+
+// "--partition <policy> <workload> --cpus K [--engine sequential|timewarp] [--workers W] [--gvt-interval E] [--window T] [quantum]"
+int run_partition(int argc, char* argv[]) {
+    Policy policy;
+    if (argc < 4 || !parse_policy(argv[2], &policy)) {
+        printf("Usage: %s --partition <fcfs|sjf|priority|rr> <workload file> --cpus K [--engine sequential|timewarp]\n"
+               "       [--workers W] [--gvt-interval E] [--window T] [quantum]\n", argv[0]);
+        return 2;
+    }
+    int cpus = 1, workers = -1, gvt_interval = TW_DEFAULT_GVT_INTERVAL, time_quantum = 2;
+    long long window = -1;
+    bool optimistic = false, quantum_seen = false;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &cpus)) return 2; }
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &workers)) return 2; }
+        else if (strcmp(argv[i], "--gvt-interval") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &gvt_interval)) return 2; }
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) { if (!parse_option_long_long(argv, &i, &window)) return 2; }
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            const char* engine = argv[++i];
+            if (strcmp(engine, "timewarp") == 0) optimistic = true;
+            else if (strcmp(engine, "sequential") == 0) optimistic = false;
+            else {
+                printf("[ERROR] Unknown engine '%s' (expected sequential or timewarp).\n", engine);
+                return 2;
+            }
+        }
+        else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) return 2;
+    }
+    if (workers == -1) workers = (cpus + 1 < 4) ? cpus + 1 : 4;
+    if (cpus <= 0 || workers <= 0 || gvt_interval <= 0 || time_quantum <= 0 || window < -1) {
+        printf("[ERROR] CPU count, workers, GVT interval and quantum must be positive integers (window >= 0).\n");
+        return 2;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[3], &w)) return 1;
+    if (w.count == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        workload_free(&w);
+        return 1;
+    }
+    int n = w.count;
+    if (window == -1) {
+        // Default optimism window: ek average burst. Zyada door tak aage chalne par dispatcher ke routing
+        // decisions purane completions par tike hote hain aur zyada kaam rollback hota hai.
+        long long total_burst = 0;
+        for (int i = 0; i < n; i++) total_burst += w.procs[i].burst_time;
+        window = (total_burst + n - 1) / n;
+    }
+    Process* result = sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE);
+    int* cpu_of = sim_malloc((size_t)n * sizeof(int), MEM_METRICS);
+    Process* check = optimistic ? sim_malloc((size_t)n * sizeof(Process), MEM_PROCESS_TABLE) : NULL;
+    int* check_cpu = optimistic ? sim_malloc((size_t)n * sizeof(int), MEM_METRICS) : NULL;
+    TwStats stats, check_stats;
+    bool ok = (result != NULL && cpu_of != NULL && (!optimistic || (check != NULL && check_cpu != NULL)));
+    if (ok) ok = partition_simulate(w.procs, n, policy, time_quantum, cpus, optimistic, workers, gvt_interval, window,
+                                    result, cpu_of, &stats);
+    if (!ok) {
+        printf("[ERROR] Failed to allocate memory for the partitioned simulation.\n");
+        sim_free(result); sim_free(cpu_of); sim_free(check); sim_free(check_cpu);
+        workload_free(&w);
+        return 1;
+    }
+
+    printf("\n--- PARTITIONED: %s on %d CPUs (join-shortest-queue), %d processes, %s engine ---\n",
+           policy_name(policy), cpus, n, optimistic ? "time warp" : "sequential");
+    printf("+-------+------------+------------------+---------------------+------------------+\n");
+    printf("| CPU   | Processes  | Avg Waiting Time | Avg Turnaround Time | Avg Response     |\n");
+    printf("+-------+------------+------------------+---------------------+------------------+\n");
+    for (int c = 0; c <= cpus; c++) {
+        long long count = 0, waiting = 0, turnaround = 0, response = 0;
+        for (int i = 0; i < n; i++) {
+            if (c < cpus && cpu_of[i] != c) continue;
+            count++;
+            waiting += result[i].waiting_time;
+            turnaround += result[i].turnaround_time;
+            response += result[i].response_time;
+        }
+        if (c == cpus) printf("+-------+------------+------------------+---------------------+------------------+\n");
+        double d = (count > 0) ? (double)count : 1.0;
+        char label[16];
+        if (c < cpus) snprintf(label, sizeof(label), "%d", c);
+        else snprintf(label, sizeof(label), "All");
+        printf("| %-5s | %-10lld | %-16.2f | %-19.2f | %-16.2f |\n", label, count, waiting / d, turnaround / d, response / d);
+    }
+    printf("+-------+------------+------------------+---------------------+------------------+\n");
+
+    if (optimistic) {
+        double efficiency = (stats.events > 0) ? 100.0 * (stats.events - stats.rolled_back) / stats.events : 100.0;
+        printf("[TIMEWARP] %d workers, window %lld: %lld events processed, %lld rolled back in %lld rollbacks\n"
+               "           (%.1f%% committed), %lld anti-messages, %lld GVT rounds, %.3f seconds.\n",
+               stats.workers, window, stats.events, stats.rolled_back, stats.rollbacks, efficiency, stats.anti_messages,
+               stats.gvt_rounds, stats.seconds);
+        // Wahi model sequential engine par, aur har process ka result compare.
+        ok = partition_simulate(w.procs, n, policy, time_quantum, cpus, false, 1, gvt_interval, 0, check, check_cpu, &check_stats);
+        int mismatches = 0;
+        for (int i = 0; ok && i < n; i++) {
+            if (check_cpu[i] != cpu_of[i] || check[i].completion_time != result[i].completion_time ||
+                check[i].response_time != result[i].response_time) {
+                if (mismatches++ == 0) {
+                    printf("[MISMATCH] PID %d: sequential CPU %d completion %d, time warp CPU %d completion %d.\n",
+                           result[i].pid, check_cpu[i], check[i].completion_time, cpu_of[i], result[i].completion_time);
+                }
+            }
+        }
+        if (!ok) printf("[ERROR] Failed to allocate memory for the sequential check.\n");
+        else if (mismatches > 0) ok = false;
+        else printf("[VERIFY] Time warp results match the sequential engine for all %d processes (sequential: %.3f seconds).\n",
+                    n, check_stats.seconds);
+    } else {
+        printf("[SEQUENTIAL] %lld events in %.3f seconds.\n", stats.events, stats.seconds);
+    }
+    if (ok && partition_verify(w.procs, n, policy, time_quantum, cpus, result, cpu_of)) {
+        printf("[VERIFY] Routing follows join-shortest-queue and every CPU matches the single-CPU engine on its processes.\n");
+    } else {
+        ok = false;
+    }
+
+    sim_free(result);
+    sim_free(cpu_of);
+    sim_free(check);
+    sim_free(check_cpu);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+// --- Event Queue Benchmark ---
+// Hold model: queue mein 'size' events bhar kar har operation ek pop aur ek push hai; naya event popped
+// time + increment par aata hai, isliye queue ka size same rehta hai aur time aage badhta hai (simulation
+// clock jaisa). Increment ke profiles alag event density dikhate hain:
+//  - dense:  exponential, mean 1. Bahut saare events ek hi time par (ties).
+//  - sparse: exponential, mean 100000. Door-door arrivals.
+//  - bursty: 95% increments 0 (cron storm), baaki exponential mean 10000.
+//  - heavy:  Pareto (alpha 1.2, scale 10). Zyaadatar paas, kabhi-kabhi bahut door.
+// Har backend same seed se chalta hai; sahi backend same (time, id) order mein pop karta hai, isliye
+// popped order ka hash sab backends mein barabar hona chahiye.
+
+typedef struct {
+    const char* name;
+    double mean;            // Exponential mean, ya Pareto scale
+    double zero_fraction;   // Itne increments 0 hote hain
+    double pareto_alpha;    // > 0 matlab Pareto, warna exponential
+} QueueBenchProfile;
+
+static const QueueBenchProfile queue_bench_profiles[] = {
+    { "dense", 1, 0, 0 },
+    { "sparse", 100000, 0, 0 },
+    { "bursty", 10000, 0.95, 0 },
+    { "heavy", 10, 0, 1.2 },
+};
+
+#define QUEUE_BENCH_PROFILES ((int)(sizeof(queue_bench_profiles) / sizeof(queue_bench_profiles[0])))
+#define QUEUE_BENCH_MAX_SIZES 16
+
+static int queue_bench_increment(const QueueBenchProfile* pr, uint64_t* rng) {
+    double u = ((sim_random(rng) >> 11) + 1) * (1.0 / 9007199254740993.0); // (0, 1]
+    if (pr->zero_fraction > 0) {
+        if (u <= pr->zero_fraction) return 0;
+        u = (u - pr->zero_fraction) / (1 - pr->zero_fraction);
+    }
+    double x = (pr->pareto_alpha > 0) ? pr->mean * (pow(u, -1.0 / pr->pareto_alpha) - 1) : -pr->mean * log(u);
+    return (x < INT_MAX / 4) ? (int)(x + 0.5) : INT_MAX / 4;
+}
+
+// Ek backend par hold model: ns per operation aur popped order ka hash. Memory na mile toh false.
+static bool queue_bench_cell(EventQueueBackend backend, const QueueBenchProfile* pr, int size, int ops, uint64_t seed,
+                             double* ns, uint64_t* hash) {
+    EventQueue q;
+    if (!event_queue_init(&q, backend, size)) {
+        event_queue_free(&q);
+        return false;
+    }
+    uint64_t rng = seed;
+    int next_id = 0;
+    bool ok = true;
+    for (int i = 0; ok && i < size; i++) ok = event_queue_push(&q, (QueuedEvent){ queue_bench_increment(pr, &rng), next_id++, 0 });
+
+    uint64_t h = 1469598103934665603ULL; // FNV-1a
+    double started = wall_seconds();
+    for (int k = 0; ok && k < ops; k++) {
+        QueuedEvent ev = event_queue_pop(&q);
+        h = (h ^ (((uint64_t)(uint32_t)ev.time << 32) | (uint32_t)ev.id)) * 1099511628211ULL;
+        int increment = queue_bench_increment(pr, &rng);
+        ev.time = (ev.time <= INT_MAX - increment) ? ev.time + increment : INT_MAX;
+        ev.id = next_id++;
+        ok = event_queue_push(&q, ev);
+    }
+    *ns = (wall_seconds() - started) * 1e9 / ops;
+    *hash = h;
+    event_queue_free(&q);
+    return ok;
+}
+
+// "--bench-queues [--ops N] [--sizes a,b,...] [--seed s]"
+int run_bench_queues(int argc, char* argv[]) {
+    int ops = 1000000;
+    uint64_t seed = 12345;
+    const char* sizes_arg = "64,4096,262144";
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &ops)) return 2; }
+        else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) sizes_arg = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            printf("Usage: %s --bench-queues [--ops N] [--sizes a,b,...] [--seed s]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int sizes[QUEUE_BENCH_MAX_SIZES];
+    int count = 0;
+    for (const char* c = sizes_arg; *c != '\0' && count < QUEUE_BENCH_MAX_SIZES; ) {
+        char* end;
+        long value = strtol(c, &end, 10);
+        if (end == c || value <= 0 || value > INT_MAX / 4) { count = 0; break; }
+        sizes[count++] = (int)value;
+        c = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') { count = 0; break; }
+    }
+    // Ids har push par badhte hain, isliye size + ops int mein aana chahiye.
+    if (count == 0 || ops <= 0 || ops > INT_MAX / 2) {
+        printf("[ERROR] Need a positive --ops (up to %d) and --sizes as up to %d positive counts.\n", INT_MAX / 2, QUEUE_BENCH_MAX_SIZES);
+        return 2;
+    }
+
+    printf("\n--- EVENT QUEUE BENCHMARK: hold model, %d pop+push operations per cell (ns per operation) ---\n", ops);
+    printf("+---------+---------+");
+    for (int b = 0; b < EVENT_QUEUE_BACKEND_COUNT; b++) printf("------------+");
+    printf("----------+\n| Profile | Size    |");
+    for (int b = 0; b < EVENT_QUEUE_BACKEND_COUNT; b++) printf(" %-10s |", event_queue_backend_name((EventQueueBackend)b));
+    printf(" Fastest  |\n+---------+---------+");
+    for (int b = 0; b < EVENT_QUEUE_BACKEND_COUNT; b++) printf("------------+");
+    printf("----------+\n");
+
+    double started = wall_seconds();
+    bool ok = true;
+    for (int p = 0; p < QUEUE_BENCH_PROFILES; p++) {
+        for (int s = 0; s < count; s++) {
+            const QueueBenchProfile* pr = &queue_bench_profiles[p];
+            double ns[EVENT_QUEUE_BACKEND_COUNT];
+            uint64_t hash[EVENT_QUEUE_BACKEND_COUNT];
+            int fastest = 0;
+            printf("| %-7s | %-7d |", pr->name, sizes[s]);
+            for (int b = 0; b < EVENT_QUEUE_BACKEND_COUNT; b++) {
+                if (!queue_bench_cell((EventQueueBackend)b, pr, sizes[s], ops, seed, &ns[b], &hash[b])) {
+                    printf(" %-10s |", "no memory");
+                    ns[b] = HUGE_VAL;
+                    ok = false;
+                    continue;
+                }
+                printf(" %10.1f |", ns[b]);
+                fflush(stdout);
+                if (ns[b] < ns[fastest]) fastest = b;
+            }
+            printf(" %-8s |\n", event_queue_backend_name((EventQueueBackend)fastest));
+            for (int b = 1; ok && b < EVENT_QUEUE_BACKEND_COUNT; b++) {
+                if (hash[b] != hash[0]) {
+                    printf("[ERROR] %s popped events in a different order than %s.\n",
+                           event_queue_backend_name((EventQueueBackend)b), event_queue_backend_name(EVENT_QUEUE_BINARY_HEAP));
+                    ok = false;
+                }
+            }
+        }
+    }
+    printf("+---------+---------+");
+    for (int b = 0; b < EVENT_QUEUE_BACKEND_COUNT; b++) printf("------------+");
+    printf("----------+\n");
+    if (!ok) printf("[ERROR] Some cells failed (out of memory or wrong event order).\n");
+    printf("| %d cells in %.3f seconds. Engine default: %s (build with -DSIM_EVENT_QUEUE, or pass --event-queue).\n",
+           QUEUE_BENCH_PROFILES * count * EVENT_QUEUE_BACKEND_COUNT, wall_seconds() - started,
+           event_queue_backend_name(SIM_EVENT_QUEUE));
+    return ok ? 0 : 1;
+}
+
+// --- Host Thread Emulation ---
+// Simulated schedule kitna asli hai, yeh dekhne ke liye har Process ek asli thread banta hai. Thread apne
+// arrival offset tak sota hai, phir burst_time units ka calibrated CPU kaam (spin loop) karta hai aur
+// jaagne aur khatam hone ke timestamps record karta hai. Saare threads chune hue cores par pinned hain aur
+// unhe host scheduler (Linux par CFS) chalata hai. Priority se nice banta hai: sabse chhoti priority
+// nice 0 aur har level ek nice upar (19 tak), isliye kisi privilege ki zaroorat nahi.
+// Kaam iterations mein tay hai, time mein nahi, isliye thread preempt ho toh uska end aage khisakta hai,
+// bilkul simulated waiting ki tarah. Measured waiting = (end - arrival) - burst, time units mein. Wahi
+// workload har policy par (pinned cores jitne CPUs ke saath) simulate karke saath-saath dikhaya jaata hai.
+// CPU affinity aur per-thread nice sirf Linux par hain; baaki POSIX systems par threads bina pinning ke chalte hain.
+
+#ifndef _WIN32
+
+#define EMULATE_MAX_THREADS 4096
+#define EMULATE_STACK_BYTES (256 * 1024)
+#define EMULATE_LEAD_NS 100000000LL      // Saare threads banne ke liye pehle arrival se pehle ka waqt
+#define EMULATE_CALIBRATE_NS 20000000LL  // Ek calibration round kam se kam itna CPU time
+#define EMULATE_MAX_CORES 64
+
+typedef struct {
+    long long target_ns;      // Arrival ka absolute time (CLOCK_MONOTONIC)
+    uint64_t iterations;      // Burst ka calibrated kaam
+    int nice;
+    bool nice_applied;
+    long long wake_ns;        // Sone ke baad pehli baar CPU mila
+    long long end_ns;
+    long long cpu_ns;         // Spin par thread ka apna CPU time
+    uint64_t sink;            // Spin ka result, taaki compiler loop hata na sake
+} EmulatedProcess;
+
+static volatile uint64_t emulate_sink; // Calibration spins ka result
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long long thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint64_t emulate_spin(uint64_t iterations) {
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (uint64_t i = 0; i < iterations; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+// Ek time unit mein kitni spin iterations. Thread ka CPU time naapa jaata hai, isliye beech mein preempt
+// hone se farq nahi padta; teen rounds mein sabse tez rate.
+static double emulate_calibrate(long long unit_ns) {
+    double best = 0;
+    for (int round = 0; round < 3; round++) {
+        for (uint64_t iterations = 1 << 16; ; iterations *= 2) {
+            long long start = thread_cpu_ns();
+            emulate_sink = emulate_spin(iterations);
+            long long spent = thread_cpu_ns() - start;
+            if (spent < EMULATE_CALIBRATE_NS) continue;
+            double rate = (double)iterations * unit_ns / spent;
+            if (rate > best) best = rate;
+            break;
+        }
+    }
+    return best;
+}
+
+static void emulate_sleep_until(long long target_ns) {
+    long long now;
+    while ((now = monotonic_ns()) < target_ns) {
+        long long left = target_ns - now;
+        struct timespec ts = { (time_t)(left / 1000000000LL), (long)(left % 1000000000LL) };
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void* emulate_thread(void* arg) {
+    EmulatedProcess* ep = arg;
+#if defined(__linux__)
+    ep->nice_applied = (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), ep->nice) == 0);
+#endif
+    emulate_sleep_until(ep->target_ns);
+    ep->wake_ns = monotonic_ns();
+    long long cpu_start = thread_cpu_ns();
+    ep->sink = emulate_spin(ep->iterations);
+    ep->end_ns = monotonic_ns();
+    ep->cpu_ns = thread_cpu_ns() - cpu_start;
+    return NULL;
+}
+
+// Har policy ka simulated waiting time, 'cpus' CPUs par (engine, multi-CPU engine jab cpus > 1).
+static bool emulate_simulate(const Workload* w, Policy policy, int time_quantum, int cpus, int waiting[]) {
+    Process* procs = sim_malloc((size_t)w->count * sizeof(Process), MEM_PROCESS_TABLE);
+    if (procs == NULL) return false;
+    memcpy(procs, w->procs, (size_t)w->count * sizeof(Process));
+    SimEngine engine;
+    bool ok = engine_init(&engine, policy, time_quantum, procs, w->count, false);
+    if (ok) {
+        if (cpus > 1) ok = engine_run_multi(&engine, cpus);
+        else engine_run(&engine);
+        for (int i = 0; ok && i < w->count; i++) waiting[i] = procs[i].waiting_time;
+        engine_free(&engine);
+    }
+    sim_free(procs);
+    return ok;
+}
+
+// "--emulate <policy> <workload> [--cores a,b,...] [--unit-us U] [quantum]"
+int run_emulate(int argc, char* argv[]) {
+    Policy policy;
+    if (argc < 4 || !parse_policy(argv[2], &policy)) {
+        printf("Usage: %s --emulate <fcfs|sjf|priority|rr> <workload file> [--cores a,b,...] [--unit-us U] [quantum]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2;
+    bool quantum_seen = false;
+    double unit_us = 1000;
+    const char* cores_arg = NULL;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--cores") == 0 && i + 1 < argc) cores_arg = argv[++i];
+        else if (strcmp(argv[i], "--unit-us") == 0 && i + 1 < argc) { if (!parse_option_double(argv, &i, &unit_us)) return 2; }
+        else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) return 2;
+    }
+    if (unit_us < 10 || time_quantum <= 0) {
+        printf("[ERROR] Need --unit-us >= 10 microseconds and a positive quantum.\n");
+        return 2;
+    }
+    long long unit_ns = (long long)(unit_us * 1000);
+
+    // Cores: comma-separated list; na diya ho toh process ko mila pehla core.
+    int cores[EMULATE_MAX_CORES];
+    int core_count = 0;
+    for (const char* c = cores_arg; c != NULL && *c != '\0' && core_count < EMULATE_MAX_CORES; ) {
+        char* end;
+        long value = strtol(c, &end, 10);
+        if (end == c || value < 0 || value > INT_MAX) { core_count = -1; break; }
+        cores[core_count++] = (int)value;
+        c = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') { core_count = -1; break; }
+    }
+    if (core_count < 0 || (cores_arg != NULL && core_count == 0)) {
+        printf("[ERROR] --cores needs a comma-separated list of CPU numbers.\n");
+        return 2;
+    }
+#if defined(__linux__)
+    cpu_set_t allowed, pinned;
+    CPU_ZERO(&pinned);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) CPU_ZERO(&allowed);
+    if (core_count == 0) {
+        for (int c = 0; c < CPU_SETSIZE && core_count == 0; c++) {
+            if (CPU_ISSET(c, &allowed)) cores[core_count++] = c;
+        }
+    }
+    for (int k = 0; k < core_count; k++) {
+        if (cores[k] >= CPU_SETSIZE || !CPU_ISSET(cores[k], &allowed)) {
+            printf("[ERROR] CPU %d is not available to this process.\n", cores[k]);
+            return 2;
+        }
+        CPU_SET(cores[k], &pinned);
+    }
+    core_count = CPU_COUNT(&pinned);
+#else
+    if (core_count == 0) core_count = 1;
+#endif
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[3], &w)) return 1;
+    if (w.count == 0 || w.count > EMULATE_MAX_THREADS) {
+        printf("[ERROR] Emulation needs between 1 and %d processes (got %d).\n", EMULATE_MAX_THREADS, w.count);
+        workload_free(&w);
+        return 1;
+    }
+    int n = w.count;
+    int min_priority = INT_MAX, min_arrival = INT_MAX;
+    long long makespan = 0;
+    for (int i = 0; i < n; i++) {
+        if (w.procs[i].priority < min_priority) min_priority = w.procs[i].priority;
+        if (w.procs[i].arrival_time < min_arrival) min_arrival = w.procs[i].arrival_time;
+    }
+
+    EmulatedProcess* eps = sim_malloc((size_t)n * sizeof(EmulatedProcess), MEM_PROCESS_TABLE);
+    pthread_t* threads = sim_malloc((size_t)n * sizeof(pthread_t), MEM_PROCESS_TABLE);
+    int* simulated = sim_malloc((size_t)POLICY_COUNT * n * sizeof(int), MEM_METRICS);
+    if (eps == NULL || threads == NULL || simulated == NULL) {
+        printf("[ERROR] Failed to allocate memory for the emulation.\n");
+        sim_free(eps); sim_free(threads); sim_free(simulated);
+        workload_free(&w);
+        return 1;
+    }
+    bool ok = true;
+    for (int p = 0; ok && p < POLICY_COUNT; p++) ok = emulate_simulate(&w, (Policy)p, time_quantum, core_count, &simulated[p * n]);
+    if (!ok) {
+        printf("[ERROR] Failed to allocate memory for the simulated runs.\n");
+        sim_free(eps); sim_free(threads); sim_free(simulated);
+        workload_free(&w);
+        return 1;
+    }
+    // Run kam se kam itna chalega: aakhri arrival + burst, ya saara kaam cores mein baant kar.
+    long long total_burst = 0;
+    for (int i = 0; i < n; i++) {
+        long long end = (long long)w.procs[i].arrival_time - min_arrival + w.procs[i].burst_time;
+        if (end > makespan) makespan = end;
+        total_burst += w.procs[i].burst_time;
+    }
+    if (total_burst / core_count > makespan) makespan = total_burst / core_count;
+
+    // Main thread bhi pinned cores par calibrate karta hai; threads apni affinity attr se lete hain.
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, EMULATE_STACK_BYTES);
+#if defined(__linux__)
+    cpu_set_t original;
+    bool restore = (pthread_getaffinity_np(pthread_self(), sizeof(original), &original) == 0);
+    pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+    pthread_attr_setaffinity_np(&attr, sizeof(pinned), &pinned);
+    int base_nice = getpriority(PRIO_PROCESS, 0);
+#else
+    int base_nice = 0;
+#endif
+    double rate = emulate_calibrate(unit_ns);
+
+    printf("\n--- EMULATION: %s workload as %d threads on %d pinned core(s), 1 time unit = %.0f us ---\n",
+           argv[3], n, core_count, unit_us);
+    printf("[CALIBRATE] %.0f spin iterations per time unit; the run takes at least %.2f seconds.\n",
+           rate, (double)makespan * unit_ns / 1e9);
+    fflush(stdout);
+
+    long long start = monotonic_ns() + EMULATE_LEAD_NS;
+    for (int i = 0; i < n; i++) {
+        int nice = base_nice + w.procs[i].priority - min_priority;
+        eps[i] = (EmulatedProcess){ start + (long long)(w.procs[i].arrival_time - min_arrival) * unit_ns,
+                                    (uint64_t)(rate * w.procs[i].burst_time), (nice < 19) ? nice : 19, false, 0, 0, 0, 0 };
+    }
+    int created = 0, create_error = 0;
+    // pthread_create errno set nahi karta, error code return karta hai.
+    while (created < n && (create_error = pthread_create(&threads[created], &attr, emulate_thread, &eps[created])) == 0) created++;
+    for (int i = 0; i < created; i++) pthread_join(threads[i], NULL);
+    pthread_attr_destroy(&attr);
+#if defined(__linux__)
+    if (restore) pthread_setaffinity_np(pthread_self(), sizeof(original), &original);
+#endif
+    if (created < n) {
+        printf("[ERROR] Could only create %d of %d threads: %s\n", created, n, strerror(create_error));
+        ok = false;
+    }
+    long long late = 0;
+    for (int i = 0; ok && i < n; i++) {
+        if (eps[i].wake_ns - eps[i].target_ns > late) late = eps[i].wake_ns - eps[i].target_ns;
+    }
+
+    if (ok) {
+        double measured_sum = 0, error_sum[POLICY_COUNT] = { 0 }, cpu_ratio = 0;
+        int nice_failed = 0;
+        printf("+-------+---------+-------+----------+------+---------------+---------------+---------------+----------+\n");
+        printf("| PID   | Arrival | Burst | Priority | Nice | Sim Waiting   | Meas Waiting  | Meas Response | CPU used |\n");
+        printf("+-------+---------+-------+----------+------+---------------+---------------+---------------+----------+\n");
+        for (int i = 0; i < n; i++) {
+            const Process* p = &w.procs[i];
+            const EmulatedProcess* ep = &eps[i];
+            double turnaround = (double)(ep->end_ns - ep->target_ns) / unit_ns;
+            double waiting = turnaround - p->burst_time;
+            double response = (double)(ep->wake_ns - ep->target_ns) / unit_ns;
+            double used = (double)ep->cpu_ns / unit_ns;
+            measured_sum += waiting;
+            cpu_ratio += (p->burst_time > 0) ? used / p->burst_time : 1;
+            for (int k = 0; k < POLICY_COUNT; k++) error_sum[k] += fabs(simulated[k * n + i] - waiting);
+#if defined(__linux__)
+            if (!ep->nice_applied) nice_failed++;
+#endif
+            printf("| %-5d | %-7d | %-5d | %-8d | %-4d | %-13d | %-13.2f | %-13.2f | %-8.2f |\n", p->pid, p->arrival_time,
+                   p->burst_time, p->priority, ep->nice, simulated[policy * n + i], waiting, response, used);
+        }
+        printf("+-------+---------+-------+----------+------+---------------+---------------+---------------+----------+\n");
+        printf("\n+----------+-------------+---------------------+\n");
+        printf("| Policy   | Avg Waiting | Mean |Sim - Meas| |\n");
+        printf("+----------+-------------+---------------------+\n");
+        int closest = 0;
+        for (int k = 0; k < POLICY_COUNT; k++) {
+            long long sum = 0;
+            for (int i = 0; i < n; i++) sum += simulated[k * n + i];
+            printf("| %-8s | %-11.2f | %-19.2f |%s\n", policy_name((Policy)k), (double)sum / n, error_sum[k] / n,
+                   (k == (int)policy) ? " <- Sim Waiting column" : "");
+            if (error_sum[k] < error_sum[closest]) closest = k;
+        }
+        printf("| %-8s | %-11.2f | %-19s |\n", "Measured", measured_sum / n, "-");
+        printf("+----------+-------------+---------------------+\n");
+        printf("[ANALYSIS] Host scheduler is closest to %s (mean per-process error %.2f time units).\n",
+               policy_name((Policy)closest), error_sum[closest] / n);
+        printf("           Threads used %.1f%% of their calibrated CPU work on average; latest wake-up was %.2f units late.\n",
+               cpu_ratio * 100 / n, (double)late / unit_ns);
+        if (nice_failed > 0) printf("[WARN] Could not set nice for %d threads; they ran at the default priority.\n", nice_failed);
+#if !defined(__linux__)
+        printf("[WARN] CPU pinning and per-thread nice need Linux; threads ran unpinned at the default priority.\n");
+#endif
+    }
+
+    sim_free(eps);
+    sim_free(threads);
+    sim_free(simulated);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+#else
+
+int run_emulate(int argc, char* argv[]) {
+    (void)argc;
+    printf("[ERROR] %s: emulation mode needs POSIX threads and is not available on Windows.\n", argv[0]);
+    return 2;
+}
+
+#endif
+
+// --- Job-Class Fluid Approximation ---
+// Bade traces mein lakhon jobs lagbhag ek jaise hote hain. Yeh mode jobs ko classes mein jodta hai
+// (arrival time bin x log2 burst bin x priority bin); har class sirf count, kul burst aur kul burst^2
+// rakhti hai. Model (single CPU) in classes par chalta hai, jobs par nahi:
+//  - Fluid hissa: policy ke preemptive order mein har group prefix (woh group aur usse upar wale) ka
+//    kaam ek fluid queue hai jo rate 1 se khali hoti hai. Har bin apne pehle aur aakhri arrival ke beech
+//    hi kaam laata hai (cron storm ek hi pal mein). Arrivals ke beech mein aaye job ka waiting = prefix
+//    backlog clear hone ka time, jabki upar wale groups ka naya kaam beech mein aata rehta hai.
+//  - Stationary hissa: har bin ek M/G/1 queue: FCFS ke liye Pollaczek-Khinchine, SJF (burst bins) aur
+//    Priority ke liye preemptive-resume priority formula, RR ke liye processor sharing (x * rho / (1 - rho)).
+//    Load FLUID_RHO_CAP par roka jaata hai; load 1 ya zyada ho toh queue sirf fluid hissa hai. RR ko
+//    processor sharing maana gaya hai, isliye bade quantum ya overload par uski galti zyada hoti hai.
+// Error estimate: kuch random windows (warm-up aur cool-down ke saath, --sample jaise) exact engine aur
+// isi model dono se chalti hain. Exact / fluid ka ratio (95% CI ke saath) model ki galti batata hai aur
+// poore trace ke fluid estimate ko calibrate karta hai. Headline calibrated estimate hi hai; kachcha fluid
+// number "model-only" label ke saath aata hai, aur galti FLUID_CALIBRATION_TOLERANCE se zyada ho toh chhupa
+// diya jaata hai. Stationary hissa Poisson arrivals maanta hai, isliye arrival gaps ka CV (Poisson = 1)
+// bhi print hota hai: barabar doori wale arrivals (CV 0) par model queue ko kaafi bada batata hai.
+
+#define FLUID_BURST_BINS 32
+#define FLUID_PRIORITY_BINS 16
+#define FLUID_RHO_CAP 0.95
+#define FLUID_CALIBRATION_TOLERANCE 0.25   // Isse zyada model error par kachcha fluid number nahi dikhate
+#define FLUID_POISSON_CV_SLACK 0.5          // Gap CV 1 se itna door ho toh uncalibrated estimate par warning
+
+typedef struct {
+    long long count;
+    double work;     // Bursts ka jod
+    double work2;    // Burst^2 ka jod
+} FluidClass;
+
+typedef struct {
+    FluidClass* classes;    // [time bin][burst bin][priority bin]
+    long long* span;        // [time bin][2]: bin ke shuru se pehle aur aakhri arrival ka offset
+    int bins;
+    long long start;        // Pehle time bin ka shuru
+    long long width;        // Time bin ki lambai
+    long long nonempty;     // Kitni classes mein kam se kam ek job hai
+} FluidModel;
+
+static int fluid_burst_bin(int burst) {
+    return (burst > 1) ? 31 - __builtin_clz((unsigned)burst) : 0;
+}
+
+// Arrival order mein [first, last) jobs ko classes mein jodta hai. Memory na mile toh false.
+static bool fluid_build(FluidModel* m, const Process procs[], const int order[], int first, int last,
+                        long long start, int bins, long long width, int priority_min, int priority_step) {
+    size_t cells = (size_t)bins * FLUID_BURST_BINS * FLUID_PRIORITY_BINS;
+    m->classes = sim_malloc(cells * sizeof(FluidClass), MEM_METRICS);
+    m->span = sim_malloc((size_t)bins * 2 * sizeof(long long), MEM_METRICS);
+    m->bins = bins;
+    m->start = start;
+    m->width = width;
+    m->nonempty = 0;
+    if (m->classes == NULL || m->span == NULL) return false;
+    memset(m->classes, 0, cells * sizeof(FluidClass));
+    for (int b = 0; b < bins; b++) {
+        m->span[2 * b] = width;
+        m->span[2 * b + 1] = -1;
+    }
+
+    for (int k = first; k < last; k++) {
+        const Process* p = &procs[order[k]];
+        long long b = (p->arrival_time - start) / width;
+        int pb = (p->priority - priority_min) / priority_step;
+        if (b < 0) b = 0;
+        if (b >= bins) b = bins - 1;
+        if (pb < 0) pb = 0;
+        if (pb >= FLUID_PRIORITY_BINS) pb = FLUID_PRIORITY_BINS - 1;
+        long long offset = p->arrival_time - start - b * width;
+        if (offset < 0) offset = 0;
+        if (offset >= width) offset = width - 1;
+        if (offset < m->span[2 * b]) m->span[2 * b] = offset;
+        if (offset > m->span[2 * b + 1]) m->span[2 * b + 1] = offset;
+        FluidClass* c = &m->classes[((size_t)b * FLUID_BURST_BINS + fluid_burst_bin(p->burst_time)) * FLUID_PRIORITY_BINS + pb];
+        if (c->count++ == 0) m->nonempty++;
+        c->work += p->burst_time;
+        c->work2 += (double)p->burst_time * p->burst_time;
+    }
+    return true;
+}
+
+// Drain ka ek hissa: 'len' time tak upar wale groups 'higher' load se aate hain. Kaam khatam ho
+// jaaye toh true aur *t mein poora time.
+static bool fluid_drain_step(double* need, double* t, double len, double higher) {
+    double net = 1 - higher;
+    if (net > 0 && *need <= net * len) {
+        *t += *need / net;
+        return true;
+    }
+    *need -= net * len;
+    *t += len;
+    return false;
+}
+
+// Bin b ke arrivals ke beech se 'need' prefix kaam clear hone ka time. Bin b ka baaki arrival hissa
+// (rest) aur uske baad ka khali hissa (idle) pehle, phir agle bins unke average load par (sigma[j *
+// groups + g - 1] upar wale groups ka load hai); trace ke baad sirf bacha kaam chalta hai.
+static double fluid_drain_time(const double sigma[], int groups, int bins, int b, int g, double need,
+                               double width, double rest, double rest_load, double idle) {
+    double t = 0;
+    if (fluid_drain_step(&need, &t, rest, rest_load) || fluid_drain_step(&need, &t, idle, 0)) return t;
+    for (int j = b + 1; j < bins; j++) {
+        if (fluid_drain_step(&need, &t, width, (g > 0) ? sigma[(size_t)j * groups + g - 1] : 0)) return t;
+    }
+    return t + need;
+}
+
+// Saare bins simulate karke [from, to) bins mein aaye jobs ka kul predicted waiting deta hai.
+static bool fluid_evaluate(const FluidModel* m, Policy policy, int from, int to, double* total_waiting) {
+    int groups = (policy == POLICY_SJF) ? FLUID_BURST_BINS : (policy == POLICY_PRIORITY) ? FLUID_PRIORITY_BINS : 1;
+    size_t cells = (size_t)m->bins * groups;
+    double* count = sim_malloc(cells * sizeof(double), MEM_METRICS);
+    double* work = sim_malloc(cells * sizeof(double), MEM_METRICS);
+    double* work2 = sim_malloc(cells * sizeof(double), MEM_METRICS);
+    double* sigma = sim_malloc(cells * sizeof(double), MEM_METRICS);
+    *total_waiting = 0;
+    if (count == NULL || work == NULL || work2 == NULL || sigma == NULL) {
+        sim_free(count); sim_free(work); sim_free(work2); sim_free(sigma);
+        return false;
+    }
+    memset(count, 0, cells * sizeof(double));
+    memset(work, 0, cells * sizeof(double));
+    memset(work2, 0, cells * sizeof(double));
+
+    // Classes ko policy ke groups mein jodo: SJF burst bin se, Priority priority bin se (chhota pehle).
+    for (int b = 0; b < m->bins; b++) {
+        for (int k = 0; k < FLUID_BURST_BINS; k++) {
+            for (int p = 0; p < FLUID_PRIORITY_BINS; p++) {
+                const FluidClass* c = &m->classes[((size_t)b * FLUID_BURST_BINS + k) * FLUID_PRIORITY_BINS + p];
+                if (c->count == 0) continue;
+                size_t i = (size_t)b * groups + ((policy == POLICY_SJF) ? k : (policy == POLICY_PRIORITY) ? p : 0);
+                count[i] += c->count;
+                work[i] += c->work;
+                work2[i] += c->work2;
+            }
+        }
+    }
+    double width = (double)m->width;
+    for (int b = 0; b < m->bins; b++) {
+        double load = 0;
+        for (int g = 0; g < groups; g++) {
+            load += work[(size_t)b * groups + g] / width;
+            sigma[(size_t)b * groups + g] = load;
+        }
+    }
+
+    double backlog[FLUID_BURST_BINS] = { 0 };  // Har prefix ka fluid backlog, bin ke shuru mein
+    double total = 0;
+    for (int b = 0; b < m->bins; b++) {
+        // Bin ke arrivals sirf [lead, lead + active) mein aate hain, isliye wahan load width / active guna.
+        double lead = 0, active = width;
+        if (m->span[2 * b + 1] >= 0) {
+            lead = (double)m->span[2 * b];
+            active = (double)(m->span[2 * b + 1] - m->span[2 * b] + 1);
+        }
+        double idle = width - lead - active, scale = width / active;
+        double residual = 0;  // Prefix ka sum lambda * E[S^2] / 2, arrival hisse mein
+        for (int g = 0; g < groups; g++) {
+            size_t i = (size_t)b * groups + g;
+            double load_le = sigma[i] * scale, load_lt = ((g > 0) ? sigma[i - 1] : 0) * scale;
+            double before = fmax(0, backlog[g] - lead);
+            residual += work2[i] / (2 * active);
+            backlog[g] = fmax(0, fmax(0, before + (load_le - 1) * active) - idle);
+            if (b < from || b >= to || count[i] == 0) continue;
+
+            double middle = fmax(0, before + (load_le - 1) * active / 2);
+            double fluid = (middle > 0)
+                ? fluid_drain_time(sigma, groups, m->bins, b, g, middle, width, active / 2, load_lt, idle) : 0;
+
+            double rho_le = fmin(load_le, FLUID_RHO_CAP), rho_lt = fmin(load_lt, FLUID_RHO_CAP);
+            double r = (load_le > FLUID_RHO_CAP) ? residual * FLUID_RHO_CAP / load_le : residual;
+            double stationary;
+            if (load_le >= 1) {
+                stationary = 0;  // Overload: queue fluid hissa hi hai
+            } else if (policy == POLICY_RR) {
+                stationary = work[i] * rho_le / (1 - rho_le);
+            } else {
+                double mean = work[i] / count[i];
+                double per_job = mean / (1 - rho_lt) + r / ((1 - rho_lt) * (1 - rho_le)) - mean;
+                stationary = count[i] * per_job;
+            }
+            total += count[i] * fluid + stationary;
+        }
+    }
+    *total_waiting = total;
+    sim_free(count); sim_free(work); sim_free(work2); sim_free(sigma);
+    return true;
+}
+
+typedef struct {
+    WindowSample exact;
+    double fluid_waiting;   // Isi window ke jobs ka model se kul waiting
+} FluidSample;
+
+// "--fluid <policy> <workload> [--bins T] [--samples S] [--window-bins W] [--seed s] [--exact] [quantum]"
+int run_fluid(int argc, char* argv[]) {
+    Policy policy;
+    if (argc < 4 || !parse_policy(argv[2], &policy)) {
+        printf("Usage: %s --fluid <fcfs|sjf|priority|rr> <workload file> [--bins T] [--samples S] [--window-bins W] [--seed s] [--exact] [quantum]\n", argv[0]);
+        return 2;
+    }
+    int time_quantum = 2, bins = 256, samples_wanted = 8, window_bins = 0;
+    uint64_t seed = 12345;
+    bool exact = false, quantum_seen = false;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--bins") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &bins)) return 2; }
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &samples_wanted)) return 2; }
+        else if (strcmp(argv[i], "--window-bins") == 0 && i + 1 < argc) { if (!parse_option_int(argv, &i, &window_bins)) return 2; }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--exact") == 0) exact = true;
+        else if (!parse_quantum_arg(argv[i], &quantum_seen, &time_quantum)) return 2;
+    }
+    if (time_quantum <= 0 || bins <= 0 || bins > 1000000 || samples_wanted < 0 || window_bins < 0) {
+        printf("[ERROR] Quantum and --bins (up to 1000000) must be positive; --samples and --window-bins cannot be negative.\n");
+        return 2;
+    }
+
+    Workload w;
+    workload_init(&w);
+    if (!load_workload_file(argv[3], &w)) return 1;
+    if (w.count == 0) {
+        printf("[ERROR] No processes to schedule.\n");
+        workload_free(&w);
+        return 1;
+    }
+
+    int* order = sim_malloc((size_t)w.count * sizeof(int), MEM_PROCESS_TABLE);
+    int* period_first = sim_malloc((size_t)w.count * sizeof(int), MEM_PROCESS_TABLE);
+    int* period_last = sim_malloc((size_t)w.count * sizeof(int), MEM_PROCESS_TABLE);
+    if (order == NULL || period_first == NULL || period_last == NULL) {
+        printf("[ERROR] Failed to allocate memory for the arrival order.\n");
+        sim_free(order); sim_free(period_first); sim_free(period_last);
+        workload_free(&w);
+        return 1;
+    }
+    sort_by_arrival(w.procs, w.count, order, period_first);
+    sample_busy_periods(w.procs, order, w.count, period_first, period_last);
+
+    long long first_arrival = w.procs[order[0]].arrival_time;
+    long long span = (long long)w.procs[order[w.count - 1]].arrival_time - first_arrival + 1;
+    long long width = (span + bins - 1) / bins;
+    bins = (int)((span + width - 1) / width);
+    int priority_min = w.procs[0].priority, priority_max = w.procs[0].priority;
+    long long total_burst = 0;
+    for (int i = 0; i < w.count; i++) {
+        if (w.procs[i].priority < priority_min) priority_min = w.procs[i].priority;
+        if (w.procs[i].priority > priority_max) priority_max = w.procs[i].priority;
+        total_burst += w.procs[i].burst_time;
+    }
+    int priority_step = (int)(((long long)priority_max - priority_min + FLUID_PRIORITY_BINS) / FLUID_PRIORITY_BINS);
+
+    // Poora trace: ek pass mein classes, phir model sirf classes par.
+    double started = wall_seconds();
+    FluidModel model;
+    bool ok = fluid_build(&model, w.procs, order, 0, w.count, first_arrival, bins, width, priority_min, priority_step);
+    double aggregated = wall_seconds();
+    double fluid_total = 0;
+    ok = ok && fluid_evaluate(&model, policy, 0, bins, &fluid_total);
+    double modelled = wall_seconds();
+    long long classes = model.nonempty;
+    if (!ok) {
+        printf("[ERROR] Failed to allocate memory for the job classes.\n");
+        sim_free(model.classes);
+        sim_free(model.span);
+        sim_free(order);
+        sim_free(period_first);
+        sim_free(period_last);
+        workload_free(&w);
+        return 1;
+    }
+    double fluid_waiting = fluid_total / w.count;
+    double mean_burst = (double)total_burst / w.count;
+
+    // Inter-arrival gaps ka coefficient of variation: Poisson arrivals par 1 ke aas-paas.
+    double gap_cv = -1;
+    if (w.count >= 3) {
+        double gap_sum = 0, gap_sq = 0;
+        for (int i = 1; i < w.count; i++) {
+            double gap = (double)w.procs[order[i]].arrival_time - w.procs[order[i - 1]].arrival_time;
+            gap_sum += gap;
+            gap_sq += gap * gap;
+        }
+        double gap_mean = gap_sum / (w.count - 1);
+        double gap_var = gap_sq / (w.count - 1) - gap_mean * gap_mean;
+        if (gap_mean > 0) gap_cv = sqrt(gap_var > 0 ? gap_var : 0) / gap_mean;
+    }
+
+    printf("\n--- FLUID: %s on %d processes -> %lld job classes (%d time bins of %lld, log2 burst bins, %d priority bins) ---\n",
+           policy_name(policy), w.count, classes, bins, width, FLUID_PRIORITY_BINS);
+    printf("| Aggregation (one pass over jobs)  : %.3f seconds\n", aggregated - started);
+    printf("| Fluid model (classes only)        : %.3f seconds\n", modelled - aggregated);
+
+    // Sampled exact run: random windows, exact engine (busy periods ke saath) aur poore trace ke model
+    // se, taaki dono taraf window mein aaya backlog same history se bane.
+    if (window_bins == 0) window_bins = (bins >= 32) ? bins / 32 : 1;
+    if (window_bins > bins) window_bins = bins;
+    int total_windows = (bins + window_bins - 1) / window_bins;
+    int sampled = (samples_wanted < total_windows) ? samples_wanted : total_windows;
+    int* window_order = sim_malloc((size_t)total_windows * sizeof(int), MEM_METRICS);
+    FluidSample* samples = sim_malloc(((size_t)sampled + 1) * sizeof(FluidSample), MEM_METRICS);
+    ok = (window_order != NULL && samples != NULL);
+    if (ok) {
+        for (int i = 0; i < total_windows; i++) window_order[i] = i;
+        for (int i = total_windows - 1; i > 0; i--) {
+            int j = (int)(sim_random(&seed) % (uint64_t)(i + 1));
+            int t = window_order[i]; window_order[i] = window_order[j]; window_order[j] = t;
+        }
+    }
+
+    long long length = (long long)window_bins * width;
+    int failures = 0;
+    started = wall_seconds();
+    #pragma omp parallel for schedule(dynamic, 1) reduction(+:failures)
+    for (int i = 0; i < (ok ? sampled : 0); i++) {
+        long long start = first_arrival + (long long)window_order[i] * length;
+        int from = window_order[i] * window_bins;
+        int to = (from + window_bins < bins) ? from + window_bins : bins;
+        bool done = simulate_window(&w, order, period_first, period_last, policy, time_quantum, start, length, &samples[i].exact) &&
+                    fluid_evaluate(&model, policy, from, to, &samples[i].fluid_waiting);
+        if (!done) failures++;
+    }
+    ok = ok && failures == 0;
+    sim_free(model.classes);
+    sim_free(model.span);
+
+    bool calibrated = false;
+    double model_error = 0;
+    double headline = fluid_waiting;
+    if (!ok) {
+        printf("[ERROR] Failed to allocate memory for a sample window.\n");
+    } else if (sampled > 0) {
+        // Ratio estimator sum(exact) / sum(fluid), windows ko clusters maan kar (ratio_estimate jaisa).
+        double sum_exact = 0, sum_fluid = 0, ss = 0;
+        long long measured = 0;
+        for (int i = 0; i < sampled; i++) {
+            sum_exact += samples[i].exact.sum_waiting;
+            sum_fluid += samples[i].fluid_waiting;
+            measured += samples[i].exact.count;
+        }
+        printf("| Sampled exact windows             : %d of %d (%lld processes, %.3f seconds)\n",
+               sampled, total_windows, measured, wall_seconds() - started);
+        if (sum_fluid > 0 && sum_exact > 0) {
+            double ratio = sum_exact / sum_fluid;
+            for (int i = 0; i < sampled; i++) {
+                double r = samples[i].exact.sum_waiting - ratio * samples[i].fluid_waiting;
+                ss += r * r;
+            }
+            double half_width = 0;
+            if (sampled >= 2) {
+                double mean_fluid = sum_fluid / sampled;
+                double fpc = 1.0 - (double)sampled / total_windows;
+                double variance = fpc * (ss / (sampled - 1)) / (sampled * mean_fluid * mean_fluid);
+                half_width = 1.96 * sqrt(variance > 0 ? variance : 0);
+            }
+            calibrated = true;
+            model_error = sum_fluid / sum_exact - 1;
+            headline = fluid_waiting * ratio;
+            printf("| Avg waiting (calibrated, 95%% CI)  : %.2f +- %.2f\n", headline, fluid_waiting * half_width);
+            printf("| Avg turnaround (calibrated)       : %.2f\n", headline + mean_burst);
+            printf("| Model error on sampled windows    : %+.1f%% (fluid %.2f vs exact %.2f avg waiting)\n",
+                   model_error * 100, measured > 0 ? sum_fluid / measured : 0, measured > 0 ? sum_exact / measured : 0);
+            if (fabs(model_error) > FLUID_CALIBRATION_TOLERANCE) {
+                printf("| Model-only avg waiting            : suppressed (error beyond the %.0f%% tolerance)\n",
+                       FLUID_CALIBRATION_TOLERANCE * 100);
+            } else {
+                printf("| Model-only avg waiting            : %.2f (uncalibrated fluid model)\n", fluid_waiting);
+            }
+        } else {
+            printf("| Model error on sampled windows    : n/a (no waiting in the sampled windows)\n");
+        }
+    }
+    if (ok && !calibrated) {
+        printf("| Avg waiting (model-only)          : %.2f (uncalibrated fluid model, no exact windows to check it)\n",
+               fluid_waiting);
+        printf("| Avg turnaround (model-only)       : %.2f\n", fluid_waiting + mean_burst);
+    }
+    if (ok) {
+        if (gap_cv >= 0) {
+            printf("| Arrival gap CV                    : %.2f (stationary M/G/1 term assumes Poisson arrivals, CV 1)\n", gap_cv);
+        } else {
+            printf("| Arrival gap CV                    : n/a (stationary M/G/1 term assumes Poisson arrivals, CV 1)\n");
+        }
+        if (!calibrated && gap_cv >= 0 && fabs(gap_cv - 1) > FLUID_POISSON_CV_SLACK) {
+            printf("[WARN] Arrivals are far from Poisson; the model-only estimate may be badly off. Sample windows with --samples.\n");
+        }
+    }
+
+    if (ok && exact) {
+        SimEngine engine;
+        started = wall_seconds();
+        ok = engine_init(&engine, policy, time_quantum, w.procs, w.count, false);
+        if (ok) {
+            engine_run(&engine);
+            double exact_waiting = (double)engine.sum_waiting / w.count;
+            printf("| Exact avg waiting (full run)      : %.2f in %.3f seconds (%s error %+.1f%%)\n",
+                   exact_waiting, wall_seconds() - started, calibrated ? "calibrated" : "model-only",
+                   exact_waiting > 0 ? (headline / exact_waiting - 1) * 100 : 0);
+            engine_free(&engine);
+        } else {
+            printf("[ERROR] Failed to allocate memory for the exact run.\n");
+        }
+    }
+
+    sim_free(order);
+    sim_free(period_first);
+    sim_free(period_last);
+    sim_free(window_order);
+    sim_free(samples);
+    workload_free(&w);
+    return ok ? 0 : 1;
+}
+
+// Sabhi processes ke liye waiting time aur turnaround time calculate karta hai.
+void calculate_metrics(Process procs[], int n) {
+    for (int i = 0; i < n; i++) {
+        if (procs[i].dropped) continue;
+        procs[i].turnaround_time = procs[i].completion_time - procs[i].arrival_time;
+        procs[i].waiting_time = procs[i].turnaround_time - procs[i].burst_time;
+    }
+}
+
+// Results ko ek saaf table format mein print karta hai.
+void print_results_table(Process procs[], int n, const char* algorithm_name) {
+    float total_wt = 0, total_tat = 0;
+    
+    // Output consistent rahe, isliye PID se sort karna.
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n - i - 1; j++) {
+            if (procs[j].pid > procs[j + 1].pid) {
+                Process temp = procs[j]; procs[j] = procs[j + 1]; procs[j + 1] = temp;
+            }
+        }
+    }
+
+    printf("\n\n--- RESULTS FOR: %s ---\n", algorithm_name);
+    printf("+-----+--------------+------------+----------+-----------------+-------------------+--------------+\n");
+    printf("| PID | Arrival Time | Burst Time | Priority | Completion Time | Turnaround Time | Waiting Time |\n");
+    printf("+-----+--------------+------------+----------+-----------------+-------------------+--------------+\n");
+    for (int i = 0; i < n; i++) {
+        printf("| %-3d | %-12d | %-10d | %-8d | %-15d | %-17d | %-12d |\n",
+               procs[i].pid, procs[i].arrival_time, procs[i].burst_time, procs[i].priority,
+               procs[i].completion_time, procs[i].turnaround_time, procs[i].waiting_time);
+        total_wt += procs[i].waiting_time;
+        total_tat += procs[i].turnaround_time;
+    }
+    printf("+-----+--------------+------------+----------+-----------------+-------------------+--------------+\n");
+    printf("| Average Waiting Time     : %.2f\n", total_wt / n);
+    printf("| Average Turnaround Time  : %.2f\n", total_tat / n);
+    printf("+------------------------------------------------------------------------------------------------+\n");
+}
+
+// Schedstat-style accounting print karta hai: chhote runs mein har process ki row, bade runs mein totals,
+// aur dono mein har CPU ki row. Dropped processes kabhi runnable nahi hue, isliye gine nahi jaate.
+void print_schedstat(const SimEngine* e, bool per_process) {
+    long long run = 0, runnable = 0, blocked = 0, scheduled = 0, preemptions = 0;
+    int counted = 0;
+    printf("\n--- SCHEDSTAT: %s ---\n", policy_name(e->policy));
+    if (per_process) {
+        printf("+-----+----------+---------------+--------------+-----------+-----------+\n");
+        printf("| PID | Run Time | Runnable Time | Blocked Time | Scheduled | Preempted |\n");
+        printf("+-----+----------+---------------+--------------+-----------+-----------+\n");
+    }
+    for (int i = 0; i < e->n; i++) {
+        const Process* p = &e->procs[i];
+        if (p->dropped) continue;
+        if (per_process) {
+            printf("| %-3d | %-8d | %-13d | %-12d | %-9d | %-9d |\n", p->pid, p->run_time, p->runnable_time,
+                   p->blocked_time, p->schedule_count, p->preemptions);
+        }
+        run += p->run_time;
+        runnable += p->runnable_time;
+        blocked += p->blocked_time;
+        scheduled += p->schedule_count;
+        preemptions += p->preemptions;
+        counted++;
+    }
+    if (per_process) printf("+-----+----------+---------------+--------------+-----------+-----------+\n");
+    if (counted > 0) {
+        printf("| Total Run / Runnable / Blocked : %lld / %lld / %lld\n", run, runnable, blocked);
+        printf("| Times Scheduled (avg)          : %lld (%.2f per process)\n", scheduled, (double)scheduled / counted);
+        printf("| Involuntary Preemptions (avg)  : %lld (%.2f per process)\n", preemptions, (double)preemptions / counted);
+    }
+
+    printf("+-----+--------------+--------------+--------+------------------+------------+-----------+\n");
+    printf("| CPU | Busy Time    | Idle Time    | Util   | Run-Queue Delay  | Timeslices | Avg Delay |\n");
+    printf("+-----+--------------+--------------+--------+------------------+------------+-----------+\n");
+    for (int c = 0; c < e->cpu_count; c++) {
+        const CpuSchedStat* cpu = &e->cpu_stats[c];
+        long long total = cpu->busy_time + cpu->idle_time;
+        printf("| %-3d | %-12lld | %-12lld | %5.1f%% | %-16lld | %-10lld | %-9.2f |\n", c, cpu->busy_time, cpu->idle_time,
+               total > 0 ? 100.0 * cpu->busy_time / total : 0.0, cpu->run_delay, cpu->timeslices,
+               cpu->timeslices > 0 ? (double)cpu->run_delay / cpu->timeslices : 0.0);
+    }
+    printf("+-----+--------------+--------------+--------+------------------+------------+-----------+\n");
+}
+
+// Ek visual ASCII Gantt chart print karta hai.
+void print_gantt_chart(GanttEntry chart[], int n) {
+    printf("\n--- GANTT CHART ---\n\n");
+
+    // Upar ka border
+    printf(" ");
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < (chart[i].end_time - chart[i].start_time) * 2; j++) printf("-");
+        printf(" ");
+    }
+    printf("\n|");
+
+    // Process IDs
+    for (int i = 0; i < n; i++) {
+        int duration = (chart[i].end_time - chart[i].start_time) * 2;
+        int padding = (duration - 4) / 2;
+        if(padding < 0) padding = 0;
+
+        for (int j = 0; j < padding; j++) printf(" ");
+        printf(" P%d ", chart[i].pid);
+        for (int j = 0; j < padding; j++) printf(" ");
+        if((duration - 4) % 2 != 0) printf(" ");
+        printf("|");
+    }
+    printf("\n ");
+
+    // Neeche ka border
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < (chart[i].end_time - chart[i].start_time) * 2; j++) printf("-");
+        printf(" ");
+    }
+    printf("\n");
+
+    // Timestamps
+    printf("%d", chart[0].start_time);
+    for (int i = 0; i < n; i++) {
+        int duration = (chart[i].end_time - chart[i].start_time) * 2;
+        for (int j = 0; j < duration; j++) printf(" ");
+
+        if (chart[i].end_time > 9) printf("\b"); // do-digit numbers ke liye adjustment
+        printf("%d", chart[i].end_time);
+    }
+    printf("\n\n");
 }
 
 
@@ -520,3 +8050,83 @@ void compare_all_algorithms() {
 } 
 
 
+// --- Fuzzing Entry Points ---
+// -DSIM_FUZZ=<target> ke saath build karne par main() ki jagah yeh libFuzzer entry point banta hai.
+#ifdef SIM_FUZZ
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    Workload w;
+    workload_init(&w);
+    bool parsed = true;
+
+#if SIM_FUZZ == SIM_FUZZ_CSV
+    int error_line = 0;
+    parsed = parse_workload_csv((const char*)data, size, &w, &error_line);
+#elif SIM_FUZZ == SIM_FUZZ_BINARY
+    parsed = parse_workload_binary(data, size, &w);
+#else
+    // Engine target: pehle do bytes policy aur quantum, phir har process ke liye 5 bytes.
+    if (size < 2) return 0;
+    Policy policy = (Policy)(data[0] % POLICY_COUNT);
+    int time_quantum = 1 + data[1] % 16;
+    for (size_t i = 2; i + 5 <= size && w.count < 256; i += 5) {
+        int arrival = data[i] | (data[i + 1] << 8);
+        int burst = 1 + (data[i + 2] | (data[i + 3] << 8));
+        workload_append(&w, arrival, burst, data[i + 4]);
+    }
+#endif
+
+#if SIM_FUZZ != SIM_FUZZ_ENGINE
+    Policy policy = (Policy)(size % POLICY_COUNT);
+    int time_quantum = 1 + (int)(size % 7);
+#endif
+#if SIM_FUZZ != SIM_FUZZ_ENGINE
+    // Packed form ka round trip: har record arrival order mein wapas same milna chahiye.
+    PackedWorkload packed;
+    if (parsed && pack_workload(&w, &packed)) {
+        int* order = sim_malloc((w.count > 0 ? w.count : 1) * sizeof(int), MEM_PROCESS_TABLE);
+        int* scratch = sim_malloc((w.count > 0 ? w.count : 1) * sizeof(int), MEM_PROCESS_TABLE);
+        Process decoded[64];
+        if (order != NULL && scratch != NULL) {
+            sort_by_arrival(w.procs, w.count, order, scratch);
+            int start = (w.count > 0) ? (int)(size % (size_t)w.count) : 0;
+            int count = (w.count - start < 64) ? w.count - start : 64;
+            unpack_workload_range(&packed, start, count, decoded);
+            for (int i = 0; i < count; i++) {
+                const Process* p = &w.procs[order[start + i]];
+                if (decoded[i].pid != p->pid || decoded[i].arrival_time != p->arrival_time ||
+                    decoded[i].burst_time != p->burst_time || decoded[i].priority != p->priority) abort();
+            }
+        }
+        sim_free(order);
+        sim_free(scratch);
+        packed_workload_free(&packed);
+    }
+#endif
+
+    // Parser ne jo workload accept kiya, usse simulate karke invariants check karo.
+    SimEngine engine;
+    if (parsed && w.count > 0 && engine_init(&engine, policy, time_quantum, w.procs, w.count, true)) {
+        engine_run(&engine);
+        if (!check_schedule_invariants(&engine)) abort();
+        engine_free(&engine);
+    }
+    workload_free(&w);
+    return 0;
+}
+
+#ifdef SIM_FUZZ_REPLAY
+// libFuzzer ke bina (jaise gcc par) crash inputs replay karne ke liye chhota main.
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        FILE* f = fopen(argv[i], "rb");
+        if (f == NULL) continue;
+        static uint8_t buffer[1 << 20];
+        size_t len = fread(buffer, 1, sizeof(buffer), f);
+        fclose(f);
+        LLVMFuzzerTestOneInput(buffer, len);
+        printf("Replayed %s (%zu bytes)\n", argv[i], len);
+    }
+    return 0;
+}
+#endif
+#endif
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <limits.h> // INT_MAX ke liye
+#include <stdint.h> // uint64_t (random workload generator) ke liye
 
 // --- Constants ---
 #define MAX_PROCESSES 100 // Simulator maximum kitne process handle kar sakta hai.
@@ -24,12 +25,31 @@ typedef struct {
     int completion_time;  // Process kab poora hua
     int waiting_time;     // Process ne ready queue mein kitna intezaar kiya
     int turnaround_time;  // Process ke aane se लेकर poora hone tak ka time
+    int response_time;    // Pehli baar CPU milne tak kitna intezaar kiya
     
     // --- Memory Simulation Feature ---
     void* memory_block;   // Simulated memory block ka pointer
     bool is_completed;    // Flag yeh batane ke liye ki process poora ho gaya hai
+    bool dropped;         // Admission control ne process ko ready queue mein aane hi nahi diya
+
+    // --- Schedstat-style accounting (engine sirf state transitions par update karta hai) ---
+    int runnable_since;   // Process kab se ready queue mein hai (arrival ya preemption)
+    int run_time;         // CPU par kul time
+    int runnable_time;    // Ready queue mein kul intezaar (schedstat run_delay)
+    int blocked_time;     // Blocked (I/O) time; is model mein process block nahi hote, isliye 0
+    int schedule_count;   // Kitni baar CPU mila
+    int preemptions;      // Involuntary switches: behtar process aaya, ya RR slice khatam hua jab koi aur intezaar kar raha tha
 } Process;
 
+// Har CPU ki schedstat-style accounting.
+typedef struct {
+    long long busy_time;
+    long long idle_time;
+    long long run_delay;      // Is CPU par dispatch hue processes ka kul ready-queue intezaar
+    long long timeslices;     // Is CPU par kitne dispatch hue
+    int idle_since;           // CPU kab khali hua (engine ke andar ka state)
+} CpuSchedStat;
+
 
 // Yeh structure Gantt chart ke ek block ko represent karta hai.
 typedef struct {
@@ -39,6 +59,384 @@ typedef struct {
 } GanttEntry;
 
 
+// Simulator ki apni memory ka hisaab rakhne ke liye subsystems.
+// Saari allocations sim_malloc/sim_realloc se hoti hain, jo bytes aur count yahan record karte hain.
+typedef enum {
+    MEM_PROCESS_TABLE,    // Workloads, packed columns, arrival order
+    MEM_QUEUES,           // Ready queues aur heaps
+    MEM_GANTT,            // Gantt chart entries
+    MEM_MEMORY_SIM,       // Process ke simulated memory blocks
+    MEM_METRICS,          // Results aur statistics
+    MEM_IO,               // File buffers aur parsing
+    MEM_SUBSYSTEM_COUNT
+} MemSubsystem;
+
+// Scheduling policies, fast engine aur validation harness ke liye.
+typedef enum {
+    POLICY_FCFS,
+    POLICY_SJF,           // Preemptive SJF (shortest remaining time)
+    POLICY_PRIORITY,      // Preemptive priority
+    POLICY_RR,            // Round Robin
+    POLICY_COUNT
+} Policy;
+
+// Ready queue ke aage admission control (single-CPU engine, --run). Har arrival par kram se:
+//  1. max_queue: ready queue (chal raha process chhod kar) bhari ho toh drop
+//  2. deadline: deadline (arrival + deadline + deadline_factor * burst) tak poora hona namumkin ho toh
+//     drop. Lower bound aage ke kaam se: FCFS mein saara backlog, SJF/Priority mein sirf jo is process
+//     se pehle chalenge, RR mein sirf apna burst.
+//  3. Token bucket: har admit ek token leta hai; token_rate per time unit se token_bucket tak bharta hai.
+// 0 matlab woh check band hai.
+typedef struct {
+    int max_queue;
+    int deadline;
+    double deadline_factor;
+    double token_rate;
+    double token_bucket;
+
+    double tokens;            // Bucket ki current state
+    int token_time;
+    long long admitted;
+    long long dropped_queue;
+    long long dropped_deadline;
+    long long dropped_rate;
+} AdmissionControl;
+
+// Time-ordered event queue (dynamic arrivals, multi-CPU slice ends). Entries (time, id, aux) order mein
+// nikalti hain, isliye har backend par simulation ke results same rehte hain. Backend build time par
+// -DSIM_EVENT_QUEUE=EVENT_QUEUE_RADIX jaise flag se, ya run time par --event-queue se chuna jaata hai.
+typedef enum {
+    EVENT_QUEUE_BINARY_HEAP,
+    EVENT_QUEUE_QUATERNARY_HEAP,  // 4-ary heap: aadhe levels, ek node ke bachche ek cache line mein
+    EVENT_QUEUE_CALENDAR,         // Brown ki calendar queue: time buckets, O(1) average
+    EVENT_QUEUE_RADIX,            // Radix heap: sirf monotone time (simulation clock) ke liye tez
+    EVENT_QUEUE_BACKEND_COUNT
+} EventQueueBackend;
+
+#ifndef SIM_EVENT_QUEUE
+#define SIM_EVENT_QUEUE EVENT_QUEUE_BINARY_HEAP
+#endif
+
+#define EVENT_RADIX_BUCKETS 33    // Bucket 0: time == pichhli key; bucket b: highest alag bit b - 1
+
+typedef struct {
+    int time;
+    int id;         // Tie-break (process index ya CPU)
+    int aux;        // Caller ka data (e.g. generation); sirf aakhri tie-break
+} QueuedEvent;
+
+// Calendar queue ka ek din: items[head..count) time order mein.
+typedef struct {
+    QueuedEvent* items;
+    int head;
+    int count;
+    int capacity;
+} EventBucket;
+
+typedef struct {
+    EventQueueBackend backend;
+    int count;
+    QueuedEvent first;        // Calendar/radix: sabse pehli entry (count > 0 par)
+
+    QueuedEvent* heap;        // Heaps: heap[0..count). Radix: entries ka node pool
+    int capacity;
+
+    // Calendar queue
+    EventBucket* buckets;
+    int bucket_count;         // Power of two
+    long long width;          // Ek bucket (din) kitne time units ka
+    int cursor;               // 'first' wala bucket
+    long long cursor_top;     // Cursor wale din ka end (offset time mein)
+
+    // Radix heap
+    int* next;                // Bucket lists aur free list ke links (-1 = end)
+    int* zero;                // Bucket 0 ke nodes ka min-heap
+    int zero_count;
+    int free_node;
+    int radix_head[EVENT_RADIX_BUCKETS];
+    unsigned radix_last;      // Pichhli pop ki key (sign bit palat kar)
+} EventQueue;
+
+// Event-driven fast engine ki state.
+// Reference algorithms har time unit par saare processes scan karte hain;
+// yeh engine seedha agle event (arrival, completion ya slice end) par jump karta hai.
+//
+// Tie-break rules (reference algorithms ke bilkul barabar):
+//  - FCFS/RR: arrival time ke order mein, same arrival par array index ka order.
+//  - SJF: sabse kam remaining time, barabar hone par chhota array index.
+//  - Priority: sabse chhota priority number, barabar hone par chhota array index.
+//  - RR: slice ke dauran aaye processes, preempt hue process se pehle queue mein jaate hain.
+//  - Jo process abhi chal raha hai, woh sirf strictly behtar process se preempt hota hai.
+typedef struct {
+    Policy policy;
+    int time_quantum;
+
+    Process* procs;       // Caller ka array, engine isi mein results likhta hai
+    int n;
+    int* order;           // Process indices, arrival order mein
+    int next_arrival;     // order[] mein agla aane wala process
+
+    int* ready;           // Ready queue: FCFS/RR ke liye ring buffer, SJF/Priority ke liye heap
+    int ready_head;
+    int ready_count;      // Kul ready processes (SJF/Priority mein heap + sorted run)
+    int heap_count;       // SJF/Priority: ready[] heap ke elements
+
+    // SJF/Priority: ek time par aaye bade batches ka sorted run (packed keys), aur sort buffers
+    uint64_t* run;
+    int run_head;
+    int run_count;
+    int run_capacity;
+    uint64_t* batch;
+    uint64_t* batch_tmp;
+    int batch_capacity;
+    int batch_tmp_capacity;
+
+    int running;          // Chal raha process ka index (-1 matlab CPU khali)
+    int slice_end;        // Running process ka agla event time (RR/FCFS)
+    int run_start;        // Running process ko CPU kab mila
+    int current_time;
+    int completed;
+    int dropped;          // Admission control se drop hue processes
+    int last_pid;         // SJF/Priority Gantt entries merge karne ke liye
+    long long busy_time;  // CPU ne kul kitna kaam kiya (invariant checks ke liye)
+
+    // Progress counters: sirf engine likhta hai, reporter bina lock ke padhta hai.
+    long long events;         // Ab tak process hue events
+    long long sum_waiting;    // Poore hue processes ka kul waiting time
+    long long sum_turnaround; // Poore hue processes ka kul turnaround time
+
+    GanttEntry* gantt;    // NULL matlab Gantt record nahi karna
+    int gantt_count;
+    int gantt_capacity;
+
+    // Streaming hooks (NULL matlab band). on_interval har asli CPU interval par chalta hai
+    // (preemption, slice end ya completion par), on_complete har process ke poore hone par.
+    void (*on_interval)(void* ctx, int pid, int start, int end);
+    void (*on_complete)(void* ctx, const Process* p);
+    void* hook_ctx;
+
+    AdmissionControl* admission; // NULL matlab har process admit hota hai
+
+    EventQueue pending;   // Dynamic arrivals (time = arrival, id = index); khali matlab sirf order[] se
+
+    CpuSchedStat* cpu_stats; // Har CPU ki accounting (engine_run_multi cpus entries tak badhata hai)
+    int cpu_count;
+} SimEngine;
+
+// File se load hone wala workload. MAX_PROCESSES ki limit sirf interactive menu ke liye hai;
+// batch runs ke liye yeh array zaroorat ke hisab se badhta hai.
+typedef struct {
+    Process* procs;
+    int count;
+    int capacity;
+} Workload;
+
+// Isse bade CSV chunks mein baant kar parallel parse hote hain (OpenMP build mein).
+#define CSV_PARALLEL_CHUNK_BYTES (4 << 20)
+
+// File ko blocks mein padhne wala workload reader (--fused jaise one-pass modes ke liye).
+#define STREAM_BLOCK_BYTES (1 << 20)
+
+typedef struct {
+    FILE* file;
+    const char* path;
+    char* buffer;          // CSV ki adhoori aakhri line agle block tak yahin rehti hai
+    size_t length;
+    size_t capacity;
+    bool binary;
+    bool done;
+    bool seen_data;        // CSV header sirf pehli non-empty line ho sakta hai
+    long long records_left; // Binary: header ke count mein se bache records
+    long long line_no;
+    long long produced;    // Ab tak diye gaye processes
+} WorkloadStream;
+
+// Trace transformation pipeline (--transform, --fused): inputs ka k-way merge aur operators.
+#define TRACE_MAX_INPUTS 64
+#define TRACE_MAX_OPS 16
+#define TRACE_BATCH_PROCESSES 4096
+
+typedef enum {
+    TRACE_OP_COMPRESS,     // arrival / factor
+    TRACE_OP_SCALE_BURST,  // burst * factor
+    TRACE_OP_FILTER,       // field compare value
+    TRACE_OP_SAMPLE        // probability factor se rakho
+} TraceOpKind;
+
+typedef struct {
+    TraceOpKind kind;
+    double factor;
+    int field;             // Filter: 0 arrival, 1 burst, 2 priority
+    int compare;           // Filter: 0 <=, 1 >=, 2 ==, 3 !=, 4 <, 5 >
+    int value;
+} TraceOp;
+
+typedef struct {
+    WorkloadStream* inputs;
+    Workload* batches;     // Har input ka current batch
+    int* positions;        // Har batch mein agla record
+    int* last_arrival;     // Merge ke liye sorted order check
+    int* heap;             // Inputs ki min-heap (current record ke arrival se)
+    int heap_count;
+    int input_count;
+    const char* const* paths;
+    bool started;
+    TraceOp ops[TRACE_MAX_OPS];
+    int op_count;
+    uint64_t rng;          // --sample ke liye
+    long long consumed;    // Inputs se padhe records
+    long long produced;    // Operators ke baad bache records
+} TracePipeline;
+
+// --fused mode itne processes jama hone ke baad (busy period ke end par) segment simulate karta hai.
+#define FUSED_SEGMENT_PROCESSES 65536
+
+// Bahut bade workloads ke liye compact, read-only representation.
+// Arrival times sorted order mein delta-encoded hote hain; har column 16-bit ya 32-bit
+// mein store hota hai, jo bhi values ki range ke hisab se chhota pade.
+// Process ki jagah ~6-12 bytes per job lagte hain (Process struct ~48 bytes ka hai).
+#define PACKED_CHECKPOINT_INTERVAL 4096  // Itne records par ek absolute arrival time
+#define PACKED_DECODE_CHUNK 1024
+
+// Engine har itne events ke baad progress/snapshot check karta hai (power of two - 1).
+#define PROGRESS_CHECK_MASK 0xFFFF
+
+typedef struct {
+    int count;
+    int arrival_width;     // Delta column ki width: 2 ya 4 bytes
+    int burst_width;       // 2 ya 4 bytes
+    int priority_width;    // 2 ya 4 bytes
+    void* arrival_deltas;  // arrival[i] - arrival[i-1] (pehle record ke liye arrival[0])
+    void* bursts;
+    void* priorities;
+    int* pids;             // NULL matlab pid = index + 1 (input pehle se arrival order mein tha)
+    int* checkpoints;      // checkpoints[k] = arrival time of record k * PACKED_CHECKPOINT_INTERVAL
+} PackedWorkload;
+
+// Shared-memory result segment ka layout (--shm). Sab integers host byte order mein hain.
+//   offset 0: ResultSegmentHeader
+//   column_offsets[c]: row_count int32 values, har column 64-byte aligned
+//   cpu_offset: cpu_count ResultCpuStat records (64-byte aligned)
+// Columns ka order RESULT_COLUMN_* jaisa hai; rows PID order mein hain.
+// Producer magic sabse aakhir mein likhta hai, isliye magic match hone par segment poora hai.
+#define RESULT_SEGMENT_MAGIC "PSIMRES"   // 8 bytes, '\0' ke saath
+#define RESULT_SEGMENT_VERSION 2
+#define RESULT_COLUMN_ALIGN 64
+
+enum {
+    RESULT_COLUMN_PID,
+    RESULT_COLUMN_COMPLETION,
+    RESULT_COLUMN_WAITING,
+    RESULT_COLUMN_TURNAROUND,
+    RESULT_COLUMN_RESPONSE,
+    RESULT_COLUMN_RUN_TIME,
+    RESULT_COLUMN_RUNNABLE_TIME,
+    RESULT_COLUMN_BLOCKED_TIME,
+    RESULT_COLUMN_SCHEDULED,
+    RESULT_COLUMN_PREEMPTED,
+    RESULT_COLUMN_COUNT
+};
+
+typedef struct {
+    int64_t busy_time;
+    int64_t idle_time;
+    int64_t run_delay;
+    int64_t timeslices;
+} ResultCpuStat;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t row_count;
+    uint64_t segment_bytes;
+    uint64_t column_offsets[RESULT_COLUMN_COUNT];
+    char policy[16];
+    uint64_t cpu_offset;
+    uint32_t cpu_count;
+    uint32_t reserved;
+} ResultSegmentHeader;
+
+// Columnar results file (--columnar). Layout (sab integers little-endian):
+//   "PSIMCOL1"
+//   chunks: har chunk ek table (results, Gantt ya CPUs) ki zyada se zyada COLUMNAR_CHUNK_ROWS rows,
+//           har column apne encoding header ke saath lagataar:
+//             u8 encoding, u8 width, u16 dict_size, i64 base, i64 delta_base, u32 payload bytes, payload
+//   footer: har chunk ke liye u32 table, u32 rows, aur har column ke liye
+//           u64 offset, u32 bytes, u32 encoding, i32 min, i32 max
+//   trailer: u64 footer offset, u32 chunk count, u32 version, "PSIMCOL1"
+// Encodings: FOR (value - base, 1/2/4 byte width), DELTA (pichhli value se farq, phir FOR),
+// DICT (<= 256 alag values ki dictionary aur 1-byte codes). Har chunk-column ke liye sabse chhoti encoding chuni jaati hai.
+// Version 2 ne results table mein schedstat columns aur CPUs table jodi; version 1 files (8 result
+// columns, CPUs table nahi) ab bhi padhi ja sakti hain. 64-bit CPU counters HI/LO int32 columns mein hain.
+#define COLUMNAR_MAGIC "PSIMCOL1"
+#define COLUMNAR_VERSION 2
+#define COLUMNAR_CHUNK_ROWS 65536
+#define COLUMNAR_MAX_COLUMNS 16
+
+typedef enum { COLUMNAR_TABLE_RESULTS, COLUMNAR_TABLE_GANTT, COLUMNAR_TABLE_CPUS, COLUMNAR_TABLE_COUNT } ColumnarTable;
+typedef enum { COLUMNAR_ENCODING_FOR, COLUMNAR_ENCODING_DELTA, COLUMNAR_ENCODING_DICT } ColumnarEncoding;
+
+// Results table ke columns
+enum {
+    RESULTS_COL_PID, RESULTS_COL_ARRIVAL, RESULTS_COL_BURST, RESULTS_COL_PRIORITY,
+    RESULTS_COL_COMPLETION, RESULTS_COL_WAITING, RESULTS_COL_TURNAROUND, RESULTS_COL_RESPONSE,
+    RESULTS_COL_RUN, RESULTS_COL_RUNNABLE, RESULTS_COL_BLOCKED, RESULTS_COL_SCHEDULED, RESULTS_COL_PREEMPTED,
+    RESULTS_COL_COUNT
+};
+#define RESULTS_COL_COUNT_V1 (RESULTS_COL_RESPONSE + 1)
+// Gantt table ke columns
+enum { GANTT_COL_PID, GANTT_COL_START, GANTT_COL_END, GANTT_COL_COUNT };
+// CPUs table ke columns (value = HI * 2^32 + (uint32) LO)
+enum {
+    CPUS_COL_CPU, CPUS_COL_BUSY, CPUS_COL_IDLE, CPUS_COL_RUN_DELAY_HI, CPUS_COL_RUN_DELAY_LO,
+    CPUS_COL_TIMESLICES_HI, CPUS_COL_TIMESLICES_LO, CPUS_COL_COUNT
+};
+
+typedef struct {
+    uint64_t offset;
+    uint32_t bytes;
+    uint32_t encoding;
+    int32_t min;
+    int32_t max;
+} ColumnarColumnInfo;
+
+typedef struct {
+    uint32_t table;
+    uint32_t rows;
+    uint32_t column_count;
+    ColumnarColumnInfo columns[COLUMNAR_MAX_COLUMNS];
+} ColumnarChunkInfo;
+
+// Streaming writer: har table ki rows buffer hoti hain aur chunk bharte hi file mein chali jaati hain.
+typedef struct {
+    FILE* file;
+    uint64_t offset;
+    int32_t* buffers[COLUMNAR_TABLE_COUNT][COLUMNAR_MAX_COLUMNS];
+    int buffered[COLUMNAR_TABLE_COUNT];
+    ColumnarChunkInfo* chunks;
+    int chunk_count;
+    int chunk_capacity;
+    bool failed;
+} ColumnarWriter;
+
+typedef struct {
+    FILE* file;
+    ColumnarChunkInfo* chunks;
+    int chunk_count;
+} ColumnarReader;
+
+// Binary workload format: "PSIM" magic, version, count, phir har process ke liye
+// arrival, burst, priority (teeno little-endian int32).
+#define WORKLOAD_BINARY_MAGIC "PSIM"
+#define WORKLOAD_BINARY_VERSION 1
+
+// Fuzz builds: -DSIM_FUZZ=<target> se main() ki jagah LLVMFuzzerTestOneInput banta hai.
+#define SIM_FUZZ_CSV 1
+#define SIM_FUZZ_BINARY 2
+#define SIM_FUZZ_ENGINE 3
+
+
 // --- Function Prototypes (Function declarations) ---
 
 // Menu aur user interaction ke functions
@@ -56,20 +454,177 @@ void run_sjf_preemptive();
 void run_priority_preemptive();
 void run_round_robin();
 
+// Reference (tick-by-tick) algorithms, validation ke liye oracle.
+// Yeh Gantt entries ki sankhya return karte hain.
+int reference_fcfs(Process procs[], int n, GanttEntry chart[]);
+int reference_sjf_preemptive(Process procs[], int n, GanttEntry chart[]);
+int reference_priority_preemptive(Process procs[], int n, GanttEntry chart[]);
+int reference_round_robin(Process procs[], int n, int time_quantum, GanttEntry chart[]);
+
+// Event queue backends (binary heap, 4-ary heap, calendar queue, radix heap)
+bool event_queue_init(EventQueue* q, EventQueueBackend backend, int capacity_hint);
+bool event_queue_push(EventQueue* q, QueuedEvent ev);
+const QueuedEvent* event_queue_top(const EventQueue* q);
+QueuedEvent event_queue_pop(EventQueue* q);
+void event_queue_free(EventQueue* q);
+const char* event_queue_backend_name(EventQueueBackend backend);
+bool parse_event_queue_backend(const char* name, EventQueueBackend* out);
+void event_queue_set_default(EventQueueBackend backend);
+int run_bench_queues(int argc, char* argv[]);
+
+// Fast event-driven engine ke functions
+bool engine_init(SimEngine* e, Policy policy, int time_quantum, Process procs[], int n, bool record_gantt);
+bool engine_step(SimEngine* e);
+void engine_run(SimEngine* e);
+void engine_advance(SimEngine* e, long long horizon);
+bool engine_run_multi(SimEngine* e, int cpus);
+bool engine_enable_dynamic_arrivals(SimEngine* e);
+bool engine_schedule_arrival(SimEngine* e, int idx);
+void admission_init(AdmissionControl* ac);
+void engine_free(SimEngine* e);
+const char* policy_name(Policy policy);
+
+bool check_schedule_invariants(const SimEngine* e);
+
+// Differential validation harness (reference vs fast engine)
+bool validate_engines(long runs, uint64_t seed);
+bool validate_sampling(long runs, uint64_t seed);
+
+// Lambe runs ke liye progress reporting (stderr par)
+void progress_enable(double interval_seconds);
+void progress_poll(const SimEngine* e, bool force);
+double wall_seconds();
+
+// Workload loading ke functions
+void workload_init(Workload* w);
+bool workload_append(Workload* w, int arrival_time, int burst_time, int priority);
+void workload_free(Workload* w);
+bool parse_workload_csv(const char* data, size_t len, Workload* out, int* error_line);
+bool parse_workload_binary(const unsigned char* data, size_t len, Workload* out);
+bool load_workload_file(const char* path, Workload* out);
+bool workload_stream_open(WorkloadStream* s, const char* path);
+bool workload_stream_next(WorkloadStream* s, Workload* batch);
+void workload_stream_close(WorkloadStream* s);
+
+// Trace transformation pipeline ke functions
+bool trace_pipeline_open(TracePipeline* tp, const char* const paths[], int count);
+bool trace_pipeline_add_op(TracePipeline* tp, const char* name, const char* arg);
+int trace_pipeline_option(TracePipeline* tp, int argc, char* argv[], int* i);
+bool trace_pipeline_next(TracePipeline* tp, Workload* batch);
+void trace_pipeline_close(TracePipeline* tp);
+int run_transform(int argc, char* argv[]);
+void load_processes_from_file();
+
+// Packed workload ke functions
+bool pack_workload(const Workload* w, PackedWorkload* out);
+void unpack_workload_range(const PackedWorkload* pw, int start, int count, Process out[]);
+size_t packed_workload_bytes(const PackedWorkload* pw);
+void packed_workload_free(PackedWorkload* pw);
+int run_batch(int argc, char* argv[]);
+int run_daemon(int argc, char* argv[]);
+bool export_results_shm(const char* name, const Process procs[], int n, Policy policy,
+                        const CpuSchedStat cpus[], int cpu_count);
+
+// Columnar results file ke functions
+bool columnar_writer_open(ColumnarWriter* w, const char* path);
+void columnar_add_result(void* writer, const Process* p);
+void columnar_add_interval(void* writer, int pid, int start, int end);
+void columnar_add_cpu_stats(ColumnarWriter* w, const SimEngine* e);
+bool columnar_writer_close(ColumnarWriter* w);
+bool columnar_reader_open(ColumnarReader* r, const char* path);
+bool columnar_read_column(ColumnarReader* r, int chunk, int column, int32_t out[]);
+void columnar_reader_close(ColumnarReader* r);
+int dump_columnar(const char* path);
+
+// Do runs ya do policies ka per-process diff
+int run_diff(int argc, char* argv[]);
+int run_policy_diff(int argc, char* argv[]);
+
+// Sampling mode: random time windows se approximate metrics
+int run_sample(int argc, char* argv[]);
+
 // Results aur Gantt chart dikhane wale functions
 void calculate_metrics(Process procs[], int n);
 void print_gantt_chart(GanttEntry chart[], int n);
 void print_results_table(Process procs[], int n, const char* algorithm_name);
+void print_schedstat(const SimEngine* e, bool per_process);
 
 // Sabhi algorithms ko compare karne wala function
 void compare_all_algorithms();
 
+// Race mode: policies lock-step mein, haarne wali policies beech mein hi chhod di jaati hain
+bool race_policies(const Process workload[], int n, int time_quantum);
+void race_all_algorithms();
+int run_race(int argc, char* argv[]);
+
+// Fused mode: ek pass mein trace padhkar saari policies ek saath simulate hoti hain
+int run_fused(int argc, char* argv[]);
+
+// Load sweep: arrival rate badal kar latency-vs-load curve aur p99 knee
+int run_sweep(int argc, char* argv[]);
+
+// Capacity search: SLO poora karne wale sabse kam CPUs
+int run_min_cpus(int argc, char* argv[]);
+int run_closed(int argc, char* argv[]);
+
+// Partitioned CPUs (har CPU ki apni queue, JSQ dispatcher): sequential ya optimistic Time Warp engine
+int run_partition(int argc, char* argv[]);
+
+// Emulation: har process ek asli thread, host scheduler par; simulated vs measured waiting
+int run_emulate(int argc, char* argv[]);
+
+// Fluid approximation: jobs classes mein (time x burst x priority bins), metrics classes par; sampled exact windows se error
+int run_fluid(int argc, char* argv[]);
+
+// Memory accounting ke functions
+void* sim_malloc(size_t size, MemSubsystem subsystem);
+void* sim_realloc(void* ptr, size_t size, MemSubsystem subsystem);
+void sim_free(void* ptr);
+void memory_stats_reset_peaks();
+long peak_rss_kb();
+void print_memory_report();
+
 // Helper functions
 void reset_process_state();
+void discard_input_line();
 void copy_processes(Process dest[], Process src[], int n);
+uint64_t sim_random(uint64_t* state);
+void sort_by_arrival(const Process procs[], int n, int order[], int scratch[]);
+int select_kth(int values[], int n, int k);
+int slo_metric(const Process* p, int metric);
 
 #endif // SIMULATOR_H
 
-/*   gcc scheduling_simulator.c -o simulator
+/*   gcc scheduling_simulator.c -o simulator -pthread -lm
+     (validation aur sampling parallel chalane ke liye: gcc -O2 -fopenmp scheduling_simulator.c -o simulator -pthread -lm;
+      AVX2 CSV parsing ke liye -mavx2 ya -march=native bhi jodein)
+
+./simulator
+./simulator --validate [runs] [seed]   (engines vs reference, phir sampling vs poora run)
+./simulator --run <fcfs|sjf|priority|rr> <workload.csv|workload.bin> [quantum] [--progress seconds] [--shm /name]
+               [--columnar results.pcol] [--max-queue N] [--rate R --bucket B] [--deadline D] [--deadline-factor F]
+./simulator --dump-columnar results.pcol
+./simulator --diff a.pcol b.pcol [--metric waiting|turnaround|response|completion|scheduled|preempted] [--top k]
+./simulator --diff-policies <workload> <policy A> <policy B> [quantum] [--metric m] [--top k]
+./simulator --sample <policy> <workload> [quantum] [--windows N] [--target-error pct] [--seed s]
+./simulator --race <workload> [quantum]
+./simulator --fused <workload|-> [quantum] [--policies fcfs,sjf,priority,rr|all] [--merge file]... [trace operators]
+./simulator --transform <workload|-> [--merge file]... [--compress F] [--scale-burst F] [--filter "priority<5"]
+               [--sample P] [--seed s] [--output file]
+./simulator --sweep <workload> [quantum] [--policies list] [--target-p99 T] [--min-load a] [--max-load b]
+               [--points N] [--tolerance t]
+./simulator --min-cpus <workload> <policy> --target X [--metric response|waiting|turnaround] [--percentile p]
+               [--event-queue binary|4ary|calendar|radix] [quantum]
+./simulator --closed <policy> --clients N[,N...] --think Z [--burst S | --service workload] [--jobs J] [--cpus C]
+               [--seed s] [--event-queue binary|4ary|calendar|radix] [quantum]
+./simulator --partition <policy> <workload> --cpus K [--engine sequential|timewarp] [--workers W] [--gvt-interval E]
+               [--window T] [quantum]
+./simulator --bench-queues [--ops N] [--sizes a,b,...] [--seed s]
+./simulator --emulate <policy> <workload> [--cores a,b,...] [--unit-us U] [quantum]
+./simulator --fluid <policy> <workload> [--bins T] [--samples S] [--window-bins W] [--seed s] [--exact] [quantum]
+     (trace operators command line ke order mein lagte hain; --run jaise modes "-" se stdin padhte hain)
+     (run ke dauran "kill -USR1 <pid>" current metrics ka snapshot stderr par print karta hai)
+./simulator --daemon <socket path> <workload files...> [--workers N]
 
-./simulator    */
\ No newline at end of file
+     Fuzz targets (clang): clang -g -O1 -fsanitize=fuzzer,address,undefined -DSIM_FUZZ=1 scheduling_simulator.c -o fuzz_csv
+     (SIM_FUZZ=1 CSV parser, 2 binary parser, 3 engine; gcc par -DSIM_FUZZ_REPLAY files replay karta hai)    */
\ No newline at end of file